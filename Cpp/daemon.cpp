@@ -0,0 +1,362 @@
+#include "include/BackEnd.hpp"
+#include "include/Config.hpp"
+#include "include/Archive.hpp"
+#include "include/FlightRecorder.hpp"
+#include "include/ResultRing.hpp"
+#include "include/SocketServer.hpp"
+#include "include/Telemetry.hpp"
+#include "include/Trace.hpp"
+#include "include/PerfCounters.hpp"
+#include "include/Realtime.hpp"
+
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+
+using namespace std;
+
+static atomic<bool> running = true;
+static atomic<bool> snapshot = false;
+
+static void stop(int){
+    running = false;
+}
+
+static void request(int){
+    snapshot = true;
+}
+
+static void toggleTrace(int){
+    Trace::enable(!Trace::enabled());
+}
+
+static void usage(const char * program){
+    fprintf(stderr,
+        "usage: %s <config>\n"
+        "\n"
+        "config keys:\n"
+        "    source      = pulse audio source name (default source when empty)\n"
+        "    frequencies = comma separated analyzer frequencies in Hz\n"
+        "    background  = comma separated subset of frequencies that may be analyzed less often under load\n"
+        "    peak        = true | false, estimate the spectrum peak every frame\n"
+        "    harmonics   = number of harmonics (the fundamental included) to report with their THD, 0 disables it\n"
+        "    harmonics_fundamental = fundamental of the harmonic analyzer in Hz\n"
+        "    harmonics_track = true | false, retune the fundamental to the peak every frame (needs peak)\n"
+        "    output      = - for stdout, none, or a file path\n"
+        "    frames      = number of frames to analyze, 0 runs until SIGINT/SIGTERM\n"
+        "    shm         = POSIX shared memory name to publish results to, e.g. /bas\n"
+        "    shm_slots   = number of frames kept in the shared memory ring\n"
+        "    socket      = unix socket path to stream results to\n"
+        "    socket_batch = frames per socket message\n"
+        "    socket_queue = batches queued per slow client before dropping the oldest\n"
+        "    archive     = columnar archive file to append results to\n"
+        "    archive_block = rows per archive block\n"
+        "    flight_seconds = seconds of raw capture kept in memory, 0 disables it\n"
+        "    flight_compress = true | false, keep the capture as 16 bit samples\n"
+        "    flight_path = WAV dump prefix, SIGUSR1 or a trigger writes <prefix>-<time>.wav\n"
+        "    flight_trigger = dump when an analyzer magnitude reaches this, 0 disables it\n"
+        "    flight_post = seconds of audio after the trigger included in the dump\n"
+        "    flight_holdoff = minimum seconds between triggered dumps\n"
+        "    stats       = - for stdout (as # comments), or a file path for per stage latency percentiles\n"
+        "    stats_interval = seconds between stats dumps\n"
+        "    realtime    = true | false, lock memory, flush denormals, prefault the stack and ask for realtime scheduling\n"
+        "    realtime_policy = fifo | rr | other\n"
+        "    realtime_priority = scheduling priority for fifo/rr\n"
+        "    realtime_cpus = comma separated cpus to pin the analysis to\n"
+        "    engine      = auto | goertzel | fft | multirate, how the analyzer magnitudes are computed\n"
+        "    extended    = true | false, multirate levels integrate a full frame of decimated samples (finer, slower)\n"
+        "    adaptive    = true | false, lower the analysis quality when frames overrun their period\n"
+        "    counters    = true | false, add hardware counters per stage (IPC, misses per sample) to the stats\n"
+        "    trace       = Chrome trace-event JSON written at exit (needs -DTRACE=ON), SIGUSR2 toggles recording\n"
+        "    trace_start = true | false, record from the first frame instead of waiting for SIGUSR2\n",
+        program
+    );
+}
+
+int main(int argc, char ** argv){
+    if(argc != 2){
+        usage(argv[0]);
+        return 1;
+    }
+
+    Config config;
+    vector<float> frequencies;
+    vector<float> background;
+    try{
+        config.load(argv[1]);
+        frequencies = config.getList("frequencies");
+        if(config.has("background"))
+            background = config.getList("background");
+    }
+    catch(const invalid_argument& e){
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    BackEnd::initialize();
+
+    string source = config.get("source");
+    if(!source.empty()){
+        bool found = false;
+        for(const string & known : BackEnd::querySources())
+            found |= known == source;
+        if(!found)
+            fprintf(stderr, "bas-daemon: unknown source %s, using the default one\n", source.data());
+        BackEnd::setSource(source);
+    }
+
+    try{
+        BackEnd::createAnalyzers(frequencies);
+        //only columns of the output can be demoted
+        vector<float> demoted;
+        for(float frequency : background)
+            if(find(frequencies.begin(), frequencies.end(), frequency) != frequencies.end())
+                demoted.push_back(frequency);
+            else
+                fprintf(stderr, "bas-daemon: background frequency %.2f is not in frequencies, ignored\n", frequency);
+        BackEnd::createAnalyzers(demoted, true);
+    }
+    catch(const invalid_argument& e){
+        fprintf(stderr, "%s\n", e.what());
+        BackEnd::cleanup();
+        return 1;
+    }
+
+    bool peak;
+    size_t frames;
+    size_t harmonics;
+    unique_ptr<ResultRingWriter> ring;
+    unique_ptr<SocketServer> server;
+    unique_ptr<ArchiveWriter> archive;
+    unique_ptr<FlightRecorder> flight;
+    string flight_path;
+    float flight_trigger, flight_post, flight_holdoff;
+    bool trace_start;
+    bool counters;
+    Deadline deadline;
+    Realtime::Profile profile;
+    try{
+        peak = config.getBool("peak", true);
+        frames = config.getSize("frames", 0);
+        harmonics = config.getSize("harmonics", 0);
+        bool track = config.getBool("harmonics_track", false);
+        if(track && !peak)
+            throw invalid_argument("bas-daemon: harmonics_track needs peak = true");
+        BackEnd::setHarmonics(config.getFloat("harmonics_fundamental", 50), harmonics, track);
+        if(config.has("shm"))
+            ring = make_unique<ResultRingWriter>(config.get("shm"), frequencies, config.getSize("shm_slots", 256));
+        if(config.has("socket"))
+            server = make_unique<SocketServer>(config.get("socket"), frequencies, config.getSize("socket_batch", 8), config.getSize("socket_queue", 64));
+        if(config.has("archive"))
+            archive = make_unique<ArchiveWriter>(config.get("archive"), frequencies, config.getSize("archive_block", 4096));
+
+        float seconds = config.getFloat("flight_seconds", 0);
+        if(seconds > 0)
+            flight = make_unique<FlightRecorder>(seconds, config.getBool("flight_compress", false));
+        flight_path = config.get("flight_path", "bas-flight");
+        flight_trigger = config.getFloat("flight_trigger", 0);
+        flight_post = config.getFloat("flight_post", 1);
+        flight_holdoff = config.getFloat("flight_holdoff", 10);
+        trace_start = config.getBool("trace_start", true);
+        counters = config.getBool("counters", false);
+        deadline.setAdaptive(config.getBool("adaptive", false));
+
+        string engine = config.get("engine", "auto");
+        if(engine != "auto" && engine != "goertzel" && engine != "fft" && engine != "multirate")
+            throw invalid_argument("bas-daemon: engine must be auto, goertzel, fft or multirate");
+        BackEnd::setEngine(
+            engine == "fft" ? SpectrumBank::FFT :
+            engine == "goertzel" ? SpectrumBank::GOERTZEL :
+            engine == "multirate" ? SpectrumBank::MULTIRATE : SpectrumBank::AUTO
+        );
+        BackEnd::setExtended(config.getBool("extended", false));
+
+        if(config.getBool("realtime", false)){
+            profile.lock_memory = true;
+            profile.flush_denormals = true;
+            profile.stack = 256 * 1024;
+            profile.policy = Realtime::policy(config.get("realtime_policy", "fifo"));
+            if(profile.policy < 0)
+                throw invalid_argument("bas-daemon: realtime_policy must be fifo, rr or other");
+            profile.priority = config.getSize("realtime_priority", 10);
+            if(config.has("realtime_cpus"))
+                for(float cpu : config.getList("realtime_cpus"))
+                    profile.cpus.push_back(cpu);
+        }
+    }
+    catch(const exception& e){
+        fprintf(stderr, "%s\n", e.what());
+        BackEnd::cleanup();
+        return 1;
+    }
+
+    string stats_path = config.get("stats", "none");
+    FILE * stats = stats_path == "none" ? nullptr : stats_path == "-" ? stdout : fopen(stats_path.data(), "w");
+    if(!stats && stats_path != "none"){
+        fprintf(stderr, "bas-daemon: could not open %s\n", stats_path.data());
+        BackEnd::cleanup();
+        return 1;
+    }
+    //the analysis runs on this thread, so this opens the group it is counted on
+    if(counters && !PerfCounters::available())
+        fprintf(stderr, "bas-daemon: hardware counters disabled, %s\n", PerfCounters::reason());
+    PerfCounters::enable(counters && PerfCounters::available());
+    uint64_t stats_interval = config.getFloat("stats_interval", 10) * 1e9;
+    uint64_t last_stats = Telemetry::now();
+
+    string trace_path = config.get("trace");
+    if(!trace_path.empty()){
+#ifndef BAS_TRACE
+        fprintf(stderr, "bas-daemon: built without trace scopes, %s will only hold thread names\n", trace_path.data());
+#endif
+        Trace::thread("bas-daemon");
+        Trace::enable(trace_start);
+    }
+
+    string path = config.get("output", "-");
+    FILE * output = path == "none" ? nullptr : path == "-" ? stdout : fopen(path.data(), "w");
+    if(!output && path != "none"){
+        fprintf(stderr, "bas-daemon: could not open %s\n", path.data());
+        BackEnd::cleanup();
+        return 1;
+    }
+
+    signal(SIGINT, stop);
+    signal(SIGTERM, stop);
+    signal(SIGUSR1, request);
+    signal(SIGUSR2, toggleTrace);
+    BackEnd::setFlightRecorder(flight.get());
+    uint64_t last_trigger = 0;
+
+    //last, so every buffer allocated above is locked and prefaulted
+    for(const string & line : Realtime::applyProcess(profile))
+        fprintf(stderr, "bas-daemon: realtime: %s\n", line.data());
+    for(const string & line : Realtime::applyThread(profile))
+        fprintf(stderr, "bas-daemon: realtime: %s\n", line.data());
+
+    //header: timestamp in ns since epoch, peak estimate, one column per analyzer,
+    //then the harmonic analyzer's fundamental, THD and one column per harmonic
+    if(output){
+        fprintf(output, "# time peak_frequency peak_magnitude");
+        for(float frequency : frequencies)
+            fprintf(output, " %.2f", frequency);
+        if(harmonics){
+            fprintf(output, " fundamental thd");
+            for(size_t k = 1; k <= harmonics; k++)
+                fprintf(output, " h%zu", k);
+        }
+        fprintf(output, "\n");
+    }
+
+    vector<float> magnitudes(frequencies.size());
+    vector<float> analyzed, values;
+    vector<size_t> columns;             // index in analyzed of each output column
+    size_t analyzed_count = 0;
+    Harmonics harmonic_results;
+    for(size_t frame = 0; running && (frames == 0 || frame < frames); frame++){
+        BackEnd::update();
+        uint64_t start = Telemetry::now();
+        uint64_t cpu = Telemetry::threadTime();
+        uint64_t timestamp = chrono::duration_cast<chrono::nanoseconds>(chrono::system_clock::now().time_since_epoch()).count();
+
+        pair<float,float> maximum = {0,0};
+        if(peak)
+            maximum = BackEnd::maximum();
+
+        //one locked pass over both banks, then back to the configured column order
+        BackEnd::queryFrequencies(analyzed, values);
+        if(columns.size() != frequencies.size() || analyzed.size() != analyzed_count){
+            analyzed_count = analyzed.size();
+            columns.resize(frequencies.size());
+            for(size_t i = 0; i < frequencies.size(); i++){
+                auto position = lower_bound(analyzed.begin(), analyzed.end(), frequencies[i]);
+                columns[i] = position != analyzed.end() && *position == frequencies[i] ? position - analyzed.begin() : analyzed.size();
+            }
+        }
+        for(size_t i = 0; i < frequencies.size(); i++)
+            magnitudes[i] = columns[i] < analyzed.size() ? values[columns[i]] : -1;
+        if(harmonics)
+            BackEnd::queryHarmonics(harmonic_results);
+
+        {
+            Telemetry::Scope scope(Telemetry::PUBLISH);
+            if(ring)
+                ring->publish(timestamp, maximum, magnitudes.data());
+            if(server)
+                server->publish(timestamp, maximum, magnitudes.data());
+
+            //a full disk must not stop the live outputs
+            if(archive)
+                try{
+                    archive->append(timestamp, magnitudes.data());
+                }
+                catch(const exception& e){
+                    fprintf(stderr, "%s\nbas-daemon: archiving disabled\n", e.what());
+                    archive.reset();
+                }
+        }
+        Telemetry::record(Telemetry::ANALYSIS_CPU, Telemetry::threadTime() - cpu);
+
+        if(flight){
+            bool triggered = false;
+            if(flight_trigger > 0 && timestamp - last_trigger > flight_holdoff * 1e9)
+                for(float magnitude : magnitudes)
+                    triggered |= magnitude >= flight_trigger;
+
+            if(triggered || snapshot.exchange(false)){
+                flight->dump(flight_path + "-" + to_string(timestamp) + ".wav", triggered ? flight_post : 0);
+                if(triggered)
+                    last_trigger = timestamp;
+            }
+        }
+
+        if(output){
+            fprintf(output, "%llu %.2f %.6f", (unsigned long long)timestamp, maximum.first, maximum.second);
+            for(float magnitude : magnitudes)
+                fprintf(output, " %.6f", magnitude);
+            if(harmonics){
+                fprintf(output, " %.2f %.6f", harmonic_results.fundamental, harmonic_results.thd);
+                for(float magnitude : harmonic_results.magnitudes)
+                    fprintf(output, " %.6f", magnitude);
+            }
+            fprintf(output, "\n");
+            fflush(output);
+        }
+
+        if(deadline.frame(Telemetry::now() - start))
+            BackEnd::setQuality(deadline.quality());
+
+        if(stats && Telemetry::now() - last_stats >= stats_interval){
+            Telemetry::print(stats, "# ");
+            if(PerfCounters::enabled())
+                PerfCounters::print(stats, "# ");
+            deadline.print(stats, "# ");
+            last_stats = Telemetry::now();
+        }
+    }
+
+    if(stats){
+        Telemetry::print(stats, "# ");
+        if(PerfCounters::enabled())
+            PerfCounters::print(stats, "# ");
+        deadline.print(stats, "# ");
+        if(stats != stdout)
+            fclose(stats);
+    }
+    if(output && output != stdout)
+        fclose(output);
+    if(!trace_path.empty()){
+        Trace::enable(false);
+        if(!Trace::write(trace_path))
+            fprintf(stderr, "bas-daemon: could not write %s\n", trace_path.data());
+        else if(Trace::dropped())
+            fprintf(stderr, "bas-daemon: trace buffers wrapped, the oldest %zu events were overwritten\n", Trace::dropped());
+    }
+    BackEnd::setFlightRecorder(nullptr);
+    BackEnd::cleanup();
+    return 0;
+}
@@ -0,0 +1,104 @@
+#ifndef ARCHIVE_HPP
+#define ARCHIVE_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Columnar archive of analysis results, two files:
+//
+//     <path>       ArchiveHeader, float frequencies[columns], then fixed size blocks:
+//                      ArchiveBlock
+//                      float minimum[columns], float scale[columns]
+//                      uint32_t time[rows]               us since ArchiveBlock::first_time
+//                      uint16_t values[columns][rows]    column major, value = minimum + q * scale
+//     <path>.idx   one ArchiveIndex per block, written once the block is on disk
+//
+// Blocks are append only, a partial block (rows < rows per block) is written
+// on flush and the next rows start a new block. A reader binary searches the
+// index and only maps the blocks and columns a query asks for.
+
+constexpr uint32_t ARCHIVE_MAGIC = 0x41534142;        // "BASA"
+constexpr uint32_t ARCHIVE_VERSION = 1;
+
+struct ArchiveHeader{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t columns;
+    uint32_t rows;                                    // rows per block
+    uint64_t block_size;
+    uint64_t data_offset;
+};
+
+struct ArchiveBlock{
+    uint64_t first_time;                              // ns since epoch
+    uint32_t rows;
+    uint32_t reserved;
+};
+
+struct ArchiveIndex{
+    uint64_t first_time;
+    uint64_t last_time;
+    uint32_t rows;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(ArchiveHeader) == 32);
+static_assert(sizeof(ArchiveBlock) == 16);
+static_assert(sizeof(ArchiveIndex) == 24);
+
+class ArchiveWriter{
+    private:
+        int data = -1;
+        int index = -1;
+        ArchiveHeader header;
+        uint64_t blocks = 0;
+        uint64_t last_time = 0;
+        size_t filled = 0;
+        std::vector<uint64_t> times;
+        std::vector<float> values;                    // column major, header.rows per column
+        std::vector<uint8_t> block;
+        void open(const std::string & path, const std::vector<float> & frequencies);
+    public:
+        ArchiveWriter(const std::string & path, const std::vector<float> & frequencies, size_t rows = 4096);
+        ~ArchiveWriter();
+        ArchiveWriter(const ArchiveWriter &) = delete;
+        ArchiveWriter & operator=(const ArchiveWriter &) = delete;
+
+        void append(uint64_t timestamp, const float * magnitudes);
+        void flush();
+};
+
+class ArchiveReader{
+    private:
+        std::string path;
+        const uint8_t * data = nullptr;
+        size_t data_length = 0;
+        const ArchiveIndex * entries = nullptr;
+        size_t index_length = 0;
+        ArchiveHeader header;
+        size_t count = 0;
+        void unmap();
+        const uint8_t * block(size_t number) const;
+    public:
+        ArchiveReader(const std::string & path);
+        ~ArchiveReader();
+        ArchiveReader(const ArchiveReader &) = delete;
+        ArchiveReader & operator=(const ArchiveReader &) = delete;
+
+        void refresh();
+        size_t columns() const;
+        size_t blocks() const;
+        const float * frequencies() const;
+        size_t column(float frequency) const;
+        uint64_t begin() const;
+        uint64_t end() const;
+
+        // callback(timestamp, magnitude) for every row of column with begin <= timestamp < end
+        template<typename F>
+        void query(size_t column, uint64_t begin, uint64_t end, F callback) const;
+};
+
+#include "../templates/Archive.tpp"
+#endif
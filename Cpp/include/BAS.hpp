@@ -8,6 +8,7 @@
 
 #include "Goertzel.hpp"
 #include "Constants.hpp"
+#include "Trace.hpp"
 
 class BAS{
     private:
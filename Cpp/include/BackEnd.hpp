@@ -3,10 +3,17 @@
 
 #include "Constants.hpp"
 #include "Goertzel.hpp"
+#include "SpectrumBank.hpp"
+#include "ChirpZ.hpp"
+#include "HarmonicAnalyzer.hpp"
 #include "Recorder.hpp"
 #include "Utils.hpp"
 #include "WBAS.hpp"
 #include "BAS.hpp"
+#include "Telemetry.hpp"
+#include "Trace.hpp"
+#include "PerfCounters.hpp"
+#include "Deadline.hpp"
 
 #include <mutex>
 #include <string>
@@ -15,19 +22,54 @@
 #include <atomic>
 #include <memory>
 #include <utility>
-#include <unordered_map>
+#include <stdexcept>
 #include <condition_variable>
 #include <pulse/pulseaudio.h>
 
+class FlightRecorder;
+
+// Magnitudes of one band analyzer, bins evenly spaced from start to stop
+struct Band{
+    float start = 0;
+    float stop = 0;
+    std::vector<float> magnitudes;
+};
+
+// Harmonic analyzer results, harmonic k at magnitudes[k - 1]
+struct Harmonics{
+    float fundamental = 0;
+    float thd = 0;
+    std::vector<float> magnitudes;
+};
+
 class BackEnd{
     private:
         static float normalization;
         static constexpr float decay = 0.99;
         static Recorder<BUFFER_SIZE> recorder;
         static std::array<float,BUFFER_SIZE> frame;
-        static std::unordered_map<float,Goertzel> analyzers;
+        static SpectrumBank analyzers;
+        static SpectrumBank background;         // low priority analyzers, thinned out under load
+        static size_t background_interval;
+        static std::vector<ChirpZ> bands;       // band analyzers, in creation order
+        static uint64_t band_generation;        // bumped by every band creation or removal
+        static HarmonicAnalyzer harmonics;
+        static bool track_peak;                 // retune the harmonics to every peak estimate
+        static uint64_t frames;
+        static bool analyzed; // analyzers already ran over the current frame
+        static void analyze();
         static BAS bas;
         static WBAS<BUFFER_SIZE> wbas;
+        static FlightRecorder * flight_recorder;
+
+        // monotonic ns the newest sample of a frame entered the source;
+        // the recorder hands out the frame read on the previous update
+        static uint64_t capture;
+        static uint64_t pending_capture;
+
+        // analyzers are edited by the GUI while the analysis thread queries them
+        static std::mutex analyzers_lock;
+        static std::mutex recorder_lock;
         
         static std::atomic<bool> read_names;
         static pa_mainloop * main_loop;
@@ -42,9 +84,29 @@ class BackEnd{
 
         static std::pair<float,float> maximum();
         static float queryFrequency(float frequency);
+        static void queryFrequencies(std::vector<float>& frequencies, std::vector<float>& magnitudes);
         static void update();
+        static uint64_t captureTime();
         static void createAnalyzer(float frequency);
         static void destroyAnalyzer(float frequency);
+        static void createAnalyzers(const std::vector<float>& frequencies, bool low_priority = false);
+        static void destroyAnalyzers(const std::vector<float>& frequencies);
+        // dense evenly spaced bins over [start, stop] through one chirp-Z transform;
+        // bands are addressed by their position in creation order; all three return
+        // the generation of the band set, which tells results of different sets apart
+        static uint64_t createBand(float start, float stop, size_t bins);
+        static uint64_t destroyBand(size_t index);
+        static uint64_t queryBands(std::vector<Band>& results);
+        // fundamental and harmonics 1 ... count, 0 disables; tracking follows maximum()
+        static void setHarmonics(float fundamental, size_t count, bool track = false);
+        static void queryHarmonics(Harmonics& results);
+        static void setFlightRecorder(FlightRecorder * recorder);
+        static void setQuality(const Quality & quality);
+        // AUTO picks Goertzel or FFT from the analyzer count and spacing, for both banks
+        static void setEngine(SpectrumBank::Engine engine);
+        static SpectrumBank::Engine engine();
+        // MULTIRATE: integrate N samples on every decimated level instead of one frame
+        static void setExtended(bool extended);
         
         static void initialize();
         static void cleanup();
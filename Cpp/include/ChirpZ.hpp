@@ -0,0 +1,49 @@
+#ifndef CHIRPZ_HPP
+#define CHIRPZ_HPP
+
+#include <array>
+#include <algorithm>
+#include <vector>
+#include <cstddef>
+
+#include "FFT.hpp"
+#include "Constants.hpp"
+
+// Band analyzer: |X(f)|^2 of the frame (the Goertzel scale) at `bins`
+// evenly spaced frequencies from start to stop, through Bluestein's chirp-Z
+// transform. The sum over the frame becomes a convolution with a chirp,
+// done with two FFTs of the next power of two above frame + bins, so dense
+// bins over a narrow band cost O((N + M) log(N + M)) instead of a Goertzel
+// pass each. The chirps and the kernel's spectrum are computed by set() and
+// whenever the frame length changes.
+class ChirpZ{
+    private:
+        float first = 0;
+        float last = 0;
+        size_t count = 0;
+        size_t frame = 0;
+        FFT fft;
+        std::vector<float> chirp_re;        // e^{-j (w0 n + dw n^2 / 2)}, n < frame
+        std::vector<float> chirp_im;
+        std::vector<float> kernel_re;       // spectrum of e^{j dw k^2 / 2}, k in (-frame, bins)
+        std::vector<float> kernel_im;
+        std::vector<float> buffer_re;
+        std::vector<float> buffer_im;
+        std::vector<float> results;
+
+        void prepare(size_t frame);
+    public:
+        ChirpZ(float start, float stop, size_t bins);
+        void set(float start, float stop, size_t bins);
+        float start() const;
+        float stop() const;
+        size_t bins() const;
+        float frequency(size_t bin) const;
+        float magnitude(size_t bin) const;
+        const std::vector<float> & magnitudes() const;
+        template<size_t N>
+        void execute(const std::array<float,N> & samples);
+};
+
+#include "../templates/ChirpZ.tpp"
+#endif
@@ -0,0 +1,25 @@
+#ifndef CONFIG_HPP
+#define CONFIG_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// key = value configuration file, one entry per line, '#' starts a comment
+class Config{
+    private:
+        std::unordered_map<std::string,std::string> entries;
+        static std::string trim(const std::string & text);
+    public:
+        Config() = default;
+        Config(const std::string & path);
+        void load(const std::string & path);
+        bool has(const std::string & key) const;
+        std::string get(const std::string & key, const std::string & fallback = "") const;
+        float getFloat(const std::string & key, float fallback) const;
+        size_t getSize(const std::string & key, size_t fallback) const;
+        bool getBool(const std::string & key, bool fallback) const;
+        std::vector<float> getList(const std::string & key) const;
+};
+
+#endif
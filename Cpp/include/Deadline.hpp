@@ -0,0 +1,63 @@
+#ifndef DEADLINE_HPP
+#define DEADLINE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+
+#include "Constants.hpp"
+
+// How much work the analysis does per frame, from full precision down
+struct Quality{
+    size_t wbas_depth;              // WBAS band halvings, 0 goes all the way down
+    size_t background_interval;     // low priority analyzers run every this many frames
+    bool fft;                       // foreground analyzers forced onto the FFT engine, whatever their spacing
+};
+
+// Compares the analysis time of every frame with the time the frame lasts
+// (BUFFER_SIZE / SAMPLE_RATE) and counts the overruns. With the adaptive
+// policy on, the smoothed load walks down the QUALITY ladder when it passes
+// `high` (or on a miss) and back up after `hold` frames under `low`, so the
+// analysis keeps up with the capture and no audio backs up in the source.
+// frame() is called by the analysis thread; the counters can be read from
+// any thread.
+class Deadline{
+    public:
+        static constexpr uint64_t PERIOD = BUFFER_SIZE * 1000000000ull / SAMPLE_RATE;    // ns
+        static constexpr size_t COOLDOWN = 8;   // frames between two degradations
+        static constexpr std::array<Quality,4> QUALITY = {{
+            {0, 1, false},
+            {8, 2, false},
+            {6, 4, true},
+            {4, 8, true}
+        }};
+
+        Deadline(float high = 0.8f, float low = 0.5f, size_t hold = 100);
+
+        // elapsed: ns spent on one frame; true when the quality level changed
+        bool frame(uint64_t elapsed);
+        void setAdaptive(bool adaptive);
+        bool adaptive() const;
+        size_t level() const;
+        const Quality & quality() const;
+        uint64_t frames() const;
+        uint64_t misses() const;
+        float load() const;     // smoothed fraction of the period in use
+        void clear();
+        void print(FILE * file, const char * prefix = "") const;
+    private:
+        float high;
+        float low;
+        size_t hold;
+        size_t calm = 0;                // consecutive frames under low
+        size_t since = 0;               // frames since the last change
+        std::atomic<bool> policy = false;
+        std::atomic<size_t> current = 0;
+        std::atomic<uint64_t> total = 0;
+        std::atomic<uint64_t> missed = 0;
+        std::atomic<float> smoothed = 0;
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef FFT_HPP
+#define FFT_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Iterative radix-2 complex FFT, in place over split real/imaginary arrays
+// (structure of arrays). The bit reversal permutation and the twiddles of
+// every stage are computed once per size and stored contiguously, so the
+// butterfly loop of each stage walks unit stride arrays the compiler
+// vectorizes. Sizes are powers of two.
+class FFT{
+    private:
+        size_t length = 0;
+        std::vector<uint32_t> reversal;
+        std::vector<float> twiddle_re;     // stage with half size h starts at h - 1
+        std::vector<float> twiddle_im;
+    public:
+        FFT(size_t size = 0);
+        void resize(size_t size);
+        size_t size() const;
+        void forward(float * re, float * im) const;
+        // unnormalized, scale by 1 / size() for the inverse transform
+        void inverse(float * re, float * im) const;
+};
+
+// Real input FFT of `size` points through one complex FFT of size / 2: even
+// samples go in the real part, odd ones in the imaginary part, and the two
+// half spectra are split apart afterwards. Input shorter than size is zero
+// padded; bins 0 ... size / 2 are kept.
+class RealFFT{
+    private:
+        size_t length = 0;
+        FFT half;
+        std::vector<float> buffer_re;
+        std::vector<float> buffer_im;
+        std::vector<float> split_re;       // e^{-2 pi j k / size}, k < size / 2
+        std::vector<float> split_im;
+        std::vector<float> spectrum_re;
+        std::vector<float> spectrum_im;
+    public:
+        RealFFT(size_t size = 0);
+        void resize(size_t size);
+        size_t size() const;
+        size_t bins() const;
+        void forward(const float * samples, size_t count);
+        float re(size_t bin) const;
+        float im(size_t bin) const;
+        // bins() values each, for loops over many bins
+        const float * re() const;
+        const float * im() const;
+        // |X[bin]|^2, the scale Goertzel reports
+        float power(size_t bin) const;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef FFTBANK_HPP
+#define FFTBANK_HPP
+
+#include <array>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+#include "FFT.hpp"
+#include "Constants.hpp"
+
+// Same interface and magnitudes (|X(f)|^2 over the frame) as GoertzelBank,
+// read off one real FFT instead of one recurrence per analyzer. The frame
+// is zero padded to OVERSAMPLING times its length, so the spectrum is
+// sampled OVERSAMPLING times per bin, and each analyzer interpolates the
+// complex spectrum (Lagrange, TAPS samples around it) before squaring.
+// The samples are first rotated as if the frame were centred on t = 0,
+// which takes the fast linear phase out and leaves a smooth function to
+// interpolate; samples past DC or Nyquist come from the conjugate symmetry
+// of a real input's spectrum. Interpolating |X| instead breaks down wherever
+// neighbouring tones interfere. Against a double precision DFT the error
+// stays within 0.05% of the frame's peak amplitude (bas-accuracy checks
+// it), the float Goertzel bank is no closer. The cost is one FFT plus
+// TAPS complex products per analyzer, whatever their number.
+class FFTBank{
+    public:
+        static constexpr size_t OVERSAMPLING = 4;
+        static constexpr size_t TAPS = 8;
+    private:
+        // real linear map of one spectrum sample into the interpolated value,
+        // a complex weight (Lagrange times rotation), conjugated for mirrored samples
+        struct Tap{
+            float re_re, re_im;             // into the real part, from re and im
+            float im_re, im_im;             // into the imaginary part
+        };
+
+        std::vector<float> frequency_list;
+        std::vector<size_t> first;          // first spectrum sample interpolated
+        std::vector<Tap> taps;              // TAPS per analyzer, for samples first ... first + TAPS - 1
+        std::vector<float> results;
+        RealFFT fft;
+
+        void rebuild(std::vector<float> && frequencies);
+        void place(size_t frame);
+    public:
+        void add(const std::vector<float> & frequencies);
+        void remove(const std::vector<float> & frequencies);
+        void clear();
+        size_t find(float frequency) const;
+        size_t size() const;
+        const std::vector<float> & frequencies() const;
+        float magnitude(size_t index) const;
+        // spacing of the spectrum samples for a frame length, Hz
+        static float resolution(size_t frame);
+        template<size_t N>
+        void execute(const std::array<float,N> & samples);
+};
+
+#include "../templates/FFTBank.tpp"
+#endif
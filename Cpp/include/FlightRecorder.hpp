@@ -0,0 +1,52 @@
+#ifndef FLIGHTRECORDER_HPP
+#define FLIGHTRECORDER_HPP
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <condition_variable>
+
+// Last N seconds of raw capture. record() is called by the capture thread,
+// it only copies into preallocated memory and bumps an atomic counter.
+// Dumps run on the recorder's own thread, streaming the ring to a WAV file
+// through a fixed size chunk, so capture never waits and memory stays at
+// ring + chunk whatever happens.
+class FlightRecorder{
+    private:
+        static constexpr size_t CHUNK = 4096;
+
+        struct Request{
+            std::string path;
+            float delay;
+        };
+
+        size_t capacity;
+        bool compress;
+        std::vector<float> samples;
+        std::vector<int16_t> compressed;
+        std::atomic<uint64_t> written = 0;
+
+        std::mutex lock;
+        std::condition_variable wake;
+        std::deque<Request> requests;
+        bool running = true;
+        std::thread worker;
+
+        void work();
+        void write(const std::string & path);
+    public:
+        FlightRecorder(float seconds, bool compress);
+        ~FlightRecorder();
+        FlightRecorder(const FlightRecorder &) = delete;
+        FlightRecorder & operator=(const FlightRecorder &) = delete;
+
+        void record(const float * frame, size_t count);
+        void dump(const std::string & path, float delay = 0);
+        size_t memory() const;
+};
+
+#endif
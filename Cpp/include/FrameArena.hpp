@@ -0,0 +1,54 @@
+#ifndef FRAMEARENA_HPP
+#define FRAMEARENA_HPP
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+// Bump allocator for data that lives for one GUI frame. allocate() moves a
+// cursor, reset() rewinds it. A frame that does not fit spills into extra
+// blocks and the next reset() grows the main block to cover it, so after
+// the first few frames a steady frame never reaches the heap.
+//     FrameVector<float> values{FrameAllocator<float>(arena)};
+class FrameArena{
+    private:
+        std::unique_ptr<std::byte[]> memory;
+        size_t length;
+        size_t used = 0;
+        std::vector<std::unique_ptr<std::byte[]>> overflow;
+        size_t overflow_bytes = 0;
+    public:
+        FrameArena(size_t capacity);
+        void * allocate(size_t bytes, size_t alignment);
+        void reset();
+        size_t capacity() const;
+        size_t size() const;
+
+        // operator new calls on the calling thread, always 0 unless BAS_ALLOCATION_COUNTER is defined
+        static size_t heapAllocations();
+};
+
+// std allocator over a FrameArena, deallocate() is a no-op
+template<typename datatype>
+class FrameAllocator{
+    public:
+        using value_type = datatype;
+        FrameArena * arena;
+
+        FrameAllocator(FrameArena & arena) noexcept;
+        template<typename other>
+        FrameAllocator(const FrameAllocator<other> & allocator) noexcept;
+        datatype * allocate(size_t count);
+        void deallocate(datatype * pointer, size_t count) noexcept;
+};
+
+template<typename first, typename second>
+bool operator==(const FrameAllocator<first> & a, const FrameAllocator<second> & b);
+template<typename first, typename second>
+bool operator!=(const FrameAllocator<first> & a, const FrameAllocator<second> & b);
+
+template<typename datatype>
+using FrameVector = std::vector<datatype, FrameAllocator<datatype>>;
+
+#include "../templates/FrameArena.tpp"
+#endif
@@ -4,17 +4,59 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <utility>
+#include <cstdint>
+
+#include "MinMaxHistory.hpp"
+#include "Spectrogram.hpp"
+#include "SpectrogramTexture.hpp"
+#include "SpectrogramPyramid.hpp"
+#include "FrameArena.hpp"
+#include "BackEnd.hpp"
 
 struct GLFWwindow;
 
 namespace FrontEnd {
 
+    // Tamanho do histórico de cada analisador (~1h30 a 48 kHz / 1024 amostras)
+    constexpr size_t HISTORY_CAPACITY = 1 << 18;
+
+    // Amostras de histórico somadas entre todos os analisadores (~200 MB com os níveis de redução);
+    // com muitos analisadores cada um fica com menos, mas nunca menos que HISTORY_MINIMUM
+    constexpr size_t HISTORY_BUDGET = 1 << 23;
+    constexpr size_t HISTORY_MINIMUM = 1 << 12;
+
+    // Máximo de rótulos de frequência no eixo Y do espectrograma
+    constexpr size_t SPECTROGRAM_LABELS = 32;
+
+    // Número de colunas (iterações) mostradas no espectrograma
+    constexpr size_t SPECTROGRAM_HISTORY = 200;
+
+    // Pirâmide do espectrograma: colunas por nível e número de níveis
+    // (o último nível cobre 8192 * 2^11 quadros, ~4 dias a 48 kHz / 1024 amostras)
+    constexpr size_t SPECTROGRAM_PYRAMID_COLUMNS = 8192;
+    constexpr size_t SPECTROGRAM_PYRAMID_LEVELS = 12;
+
+    // Memória da pirâmide sem arquivo (~256 MB): com muitas linhas cada nível guarda menos colunas
+    // (2048 analisadores: ~1400 colunas, o último nível ainda cobre ~17 h); com --spectrogram-spill
+    // o arquivo guarda todas
+    constexpr size_t SPECTROGRAM_PYRAMID_BUDGET = size_t(256) << 20;
+
+    // Colunas extras enviadas à esquerda da janela da pirâmide, para o envio incremental tolerar
+    // a variação de uma ou duas colunas na largura da janela enquanto ela avança
+    constexpr uint64_t SPECTROGRAM_PYRAMID_SLACK = 4;
+
+    // Tamanho inicial da arena de temporários de cada quadro (cresce se um quadro não couber)
+    constexpr size_t FRAME_ARENA_SIZE = 64 * 1024;
+
     // Estrutura para armazenar os dados de cada analisador Goertzel
     struct GoertzelAnalyzerData {
         float frequency = 0.0f; // Frequência alvo para o algoritmo Goertzel
         bool running = false;   // Indica se a análise está em execução
-        std::vector<float> spectrum_history; // Histórico dos valores de magnitude (para plot)
-        double last_update_time = 0.0; // Momento da última atualização
+        bool low_priority = false; // Analisado com menos frequência quando o prazo aperta
+        MinMaxHistory spectrum_history; // Histórico dos valores de magnitude em várias resoluções (para plot)
+
+        GoertzelAnalyzerData(float frequency, size_t history) : frequency(frequency), spectrum_history(history) {}
 
         // Para o espectrograma simulado
         std::vector<std::vector<float>> spectrum_history_matrix; // Matriz para heatmap (espectrograma)
@@ -38,10 +80,21 @@ namespace FrontEnd {
         static void startAnalyzer(float frequency);
         static void stopAnalyzer(float frequency);
 
+        // Criação/remoção em lote (uma única realocação do banco de analisadores)
+        static void addAnalyzers(const std::vector<float>& frequencies, bool low_priority = false);
+        static void setPriority(float frequency, bool low_priority);
+        static void removeAnalyzers(const std::vector<float>& frequencies);
+
         // Funções para seleção de fonte de áudio
         static void setAudioSource(const std::string& source);
         static std::vector<std::string> getAvailableAudioSources();
 
+        // Arquivo para onde a pirâmide do espectrograma é mapeada (vazio: só memória)
+        static void setSpectrogramSpill(const std::string& path);
+
+        // Arquivo do trace da linha do tempo, gravado ao sair e pela página de desempenho (vazio: desligado)
+        static void setTracePath(const std::string& path);
+
         // Função para limitar um float a duas casas decimais
         static float limitToTwoDecimals(float value);
 
@@ -49,17 +102,73 @@ namespace FrontEnd {
         // Mapa para gerenciar múltiplas instâncias de GoertzelAnalyzerData por frequência
         static std::map<float, GoertzelAnalyzerData> s_analyzers_data;
         static float s_new_frequency_input; // Frequência a ser adicionada/removida
+        static std::vector<float> s_analyzer_list; // Frequências em ordem, para acesso por índice na lista
         static int s_selected_source_index; // Índice da fonte de áudio selecionada
         static std::vector<std::string> s_audio_sources; // Lista de fontes de áudio disponíveis
+
+        // Parâmetros da grade de analisadores
+        static float s_grid_start;
+        static float s_grid_stop;
+        static int s_grid_count;
+        static bool s_grid_logarithmic;
+        static bool s_grid_low_priority;
+        static size_t historyCapacity(size_t analyzers);
+
+        // Analisadores de banda (chirp-Z), na ordem de criação, com as últimas magnitudes
+        static std::vector<Band> s_bands;
+        static uint64_t s_band_generation;          // conjunto de bandas que s_bands descreve
+        static float s_band_start;
+        static float s_band_stop;
+        static int s_band_bins;
+        static void addBand(float start, float stop, int bins);
+        static void removeBand(size_t index);
+
+        // Analisador harmônico: fundamental e harmônicas com a distorção (THD) do último quadro
+        static Harmonics s_harmonics;
+        static float s_harmonic_fundamental;
+        static int s_harmonic_count;
+        static bool s_harmonic_track;
+        static void setHarmonics(float fundamental, int count, bool track);
         
         // Variáveis de controle de dB para o espectrograma
         static double s_min_magnitude;
         static double s_max_magnitude;
 
+        // Espectrograma persistente, atualizado uma coluna por análise
+        static Spectrogram s_spectrogram;
+        static SpectrogramTexture s_spectrogram_texture; // Renderização por textura (sem geometria por célula)
+        static std::vector<float> s_spectrogram_column;
+        static std::vector<double> s_spectrogram_ticks;
+        static std::vector<std::string> s_spectrogram_labels;
+        static std::vector<const char*> s_spectrogram_label_pointers;
+
+        // Histórico longo do espectrograma, desenhado quando o zoom sai das últimas colunas
+        static SpectrogramPyramid s_spectrogram_pyramid;
+        static SpectrogramTexture s_pyramid_texture;
+        static SpectrogramPyramid::Window s_pyramid_window; // Janela enviada por último à textura
+        static std::vector<float> s_pyramid_columns;
+        static bool s_pyramid_mean;
+        static void rebuildSpectrogram();
+        static void pushSpectrogramColumn();
+
+        // Temporários das páginas, descartados a cada render()
+        static FrameArena s_frame_arena;
+
+        // Resultados da thread de análise
+        static std::pair<float, float> s_peak;
+        static uint64_t s_last_captured;  // Captura do resultado mais novo ainda não desenhado
+        static uint64_t s_last_published; // Publicação do mesmo resultado
+        static int s_performance_metric;  // Métrica mostrada no histograma
+        static std::string s_trace_path;
+        static int s_engine;              // SpectrumBank::Engine pedido
+        static bool s_extended;           // Janelas longas do motor multitaxa
+        static void consumeAnalyses();
+
         // Páginas da interface
         static void showConfigurationPage();
         static void showVisualizationPage();
         static void showOverallVisualizationPage();
+        static void showPerformancePage();
     };
 
 }
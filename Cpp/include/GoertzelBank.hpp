@@ -0,0 +1,44 @@
+#ifndef GOERTZELBANK_HPP
+#define GOERTZELBANK_HPP
+
+#include <array>
+#include <vector>
+#include <cstddef>
+
+#include "Constants.hpp"
+
+// Many Goertzel analyzers over the same frame. Frequencies are kept sorted
+// and unique, and the coefficients are laid out as structure of arrays
+// padded to PADDING, so execute() runs LANES independent recurrences per
+// sample that the compiler turns into vector code (LANES must divide
+// PADDING, 8 fills an AVX register). add()/remove() take a whole list and
+// rebuild the arrays once.
+class GoertzelBank{
+    public:
+        static constexpr size_t PADDING = 16;
+        static constexpr size_t LANES = 8;
+    private:
+
+        std::vector<float> frequency_list;
+        std::vector<float> iir_1;
+        std::vector<float> fir_1;
+        std::vector<float> fir_2;
+        std::vector<float> results;
+
+        void rebuild(std::vector<float> && frequencies);
+    public:
+        void add(const std::vector<float> & frequencies);
+        void remove(const std::vector<float> & frequencies);
+        void clear();
+        size_t find(float frequency) const;
+        size_t size() const;
+        const std::vector<float> & frequencies() const;
+        float magnitude(size_t index) const;
+        template<size_t N, size_t WIDTH = LANES>
+        void execute(const std::array<float,N> & samples);
+        template<size_t WIDTH = LANES>
+        void execute(const float * samples, size_t count);
+};
+
+#include "../templates/GoertzelBank.tpp"
+#endif
@@ -0,0 +1,51 @@
+#ifndef HARMONICANALYZER_HPP
+#define HARMONICANALYZER_HPP
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+#include "Constants.hpp"
+
+// A fundamental and its harmonics 1 ... count (1 is the fundamental), each
+// reported as |X(k f)|^2 over the frame like GoertzelBank, plus their total
+// harmonic distortion. The coefficients of harmonic k come from those of
+// harmonic k - 1 through the Chebyshev recurrence
+//     cos(k w) = 2 cos(w) cos((k - 1) w) - cos((k - 2) w)
+// (and the same for sin), so retune() costs one cos/sin pair and a few
+// multiplies per harmonic: cheap enough to follow the peak every frame.
+// execute() runs all the recurrences in one sweep over the frame, lanes
+// padded to LANES so the compiler keeps them in vector registers.
+// Harmonics above half the sample rate read 0 and stay out of the THD.
+class HarmonicAnalyzer{
+    public:
+        static constexpr size_t MAX_HARMONICS = 32;
+        static constexpr size_t LANES = 8;
+    private:
+        float base = 0;
+        size_t count = 0;
+        size_t active = 0;                  // harmonics below half the sample rate
+        std::array<float,MAX_HARMONICS> iir_1 = {};
+        std::array<float,MAX_HARMONICS> fir_1 = {};
+        std::array<float,MAX_HARMONICS> fir_2 = {};
+        std::array<float,MAX_HARMONICS> results = {};
+
+        template<size_t N, size_t WIDTH>
+        void sweep(const std::array<float,N> & samples);
+    public:
+        HarmonicAnalyzer(float fundamental = 0, size_t harmonics = 0);
+        void set(float fundamental, size_t harmonics);
+        // new fundamental, same harmonic count; false (and nothing changes) outside (0, SAMPLE_RATE / 2]
+        bool retune(float fundamental);
+        float fundamental() const;
+        size_t harmonics() const;
+        // harmonic number 1 ... harmonics()
+        float magnitude(size_t harmonic) const;
+        // sqrt(sum of |X(k f)|^2 for k >= 2) / |X(f)|, 0 without a fundamental
+        float thd() const;
+        template<size_t N>
+        void execute(const std::array<float,N> & samples);
+};
+
+#include "../templates/HarmonicAnalyzer.tpp"
+#endif
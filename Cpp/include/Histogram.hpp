@@ -0,0 +1,41 @@
+#ifndef HISTOGRAM_HPP
+#define HISTOGRAM_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Lock-free log-linear (HDR style) histogram of nanosecond durations.
+// Values below 2^SUB_BITS get a bucket each, above that every power of two
+// is split into 2^SUB_BITS buckets, so any value is kept within 1/2^SUB_BITS
+// (~1.6%) over the whole 64 bit range. record() is a count-leading-zeros
+// and one relaxed atomic add (plus a compare-exchange on a new maximum),
+// wait-free for any number of writers. Totals and percentiles are summed
+// from the buckets by the reader, which sees a slightly torn but always
+// usable view.
+class Histogram{
+    private:
+        static constexpr size_t SUB_BITS = 6;
+        static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BITS;
+        static constexpr size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+        std::atomic<uint64_t> counts[BUCKETS];
+        std::atomic<uint64_t> largest;
+
+        static size_t bucket(uint64_t value);
+    public:
+        Histogram();
+        void record(uint64_t value);
+        void clear();
+        size_t size() const;
+        uint64_t lower(size_t bucket) const;
+        uint64_t upper(size_t bucket) const;
+        uint64_t count(size_t bucket) const;
+        uint64_t samples() const;
+        double mean() const;
+        uint64_t maximum() const;
+        uint64_t percentile(double quantile) const;
+};
+
+#include "../templates/Histogram.tpp"
+#endif
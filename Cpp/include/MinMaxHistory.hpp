@@ -0,0 +1,42 @@
+#ifndef MINMAXHISTORY_HPP
+#define MINMAXHISTORY_HPP
+
+#include <vector>
+#include <cstddef>
+
+// Long magnitude history kept at several resolutions. Level 0 holds the raw
+// samples, level k holds one (min, max) pair per 2^k samples, interleaved, so
+// a level drawn with ImPlot::PlotLine zigzags through the envelope of the raw
+// signal. Every level is updated on push() (O(levels)) and stored twice like
+// Spectrogram, so any range of it is one contiguous block. The plot picks
+// the coarsest level that still has a point per pixel of the visible range:
+//     size_t k = history.level(visible_samples, pixels);
+//     MinMaxHistory::Window w = history.window(k, x_min, x_max);
+//     ImPlot::PlotLine(label, w.data, w.count, w.xscale, w.xstart);
+// x is measured in samples ago: the newest sample sits at 0, older ones are negative.
+class MinMaxHistory{
+    public:
+        struct Window{
+            const float * data;
+            size_t count;
+            double xscale;
+            double xstart;
+        };
+    private:
+        size_t length;
+        size_t total = 0;
+        std::vector<std::vector<float>> memory;
+    public:
+        MinMaxHistory(size_t capacity);
+        void push(float sample);
+        void clear();
+        size_t size() const;
+        size_t capacity() const;
+        bool empty() const;
+        float back() const;
+        size_t levels() const;
+        size_t level(double samples, double pixels) const;
+        Window window(size_t level, double from, double to) const;
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef MULTIRATEBANK_HPP
+#define MULTIRATEBANK_HPP
+
+#include <array>
+#include <vector>
+#include <cstddef>
+
+#include "GoertzelBank.hpp"
+#include "Constants.hpp"
+
+// Same interface and magnitudes as GoertzelBank, with low frequency
+// analyzers run on a decimated copy of the input. Every frame feeds a
+// pyramid of half-band decimators by 2 (a symmetric FIR of TAPS taps, only
+// the odd ones nonzero, evaluated at the output rate only), built as deep
+// as the lowest analyzer needs. An analyzer sits on the deepest level whose
+// usable band, COVERAGE of its Nyquist frequency, still holds it, where the
+// decimators leave the passband flat and alias below -75 dB. Filter states
+// carry over between frames, so levels see a continuous stream.
+//
+// By default every level analyzes the span of one frame, N / 2^level
+// samples, and its magnitudes are scaled back by (2^level)^2 to the full
+// rate ones. Extended windows keep N samples at every level instead: the
+// deep levels integrate 2^level frames, resolving 2^level times finer
+// around low frequencies for the cost of one full rate pass.
+class MultirateBank{
+    public:
+        static constexpr size_t LEVELS = 6;             // decimation by up to 2^LEVELS
+        static constexpr size_t TAPS = 47;              // 4k - 1, the ends are zero in a half-band
+        static constexpr float COVERAGE = 0.75f;
+    private:
+        struct Level{
+            GoertzelBank bank;                  // frequencies times 2^level, as if at the full rate
+            std::vector<size_t> analyzers;      // index in frequency_list of each bank entry
+            std::vector<float> input;           // TAPS - 1 previous samples, then this frame's
+            std::vector<float> output;          // this frame's decimated samples
+            std::vector<float> window;          // samples analyzed, oldest first
+        };
+
+        std::vector<float> frequency_list;
+        std::vector<float> results;
+        std::array<Level,LEVELS + 1> levels;
+        std::array<float,(TAPS + 1) / 4> taps;  // at center +- 1, +- 3, ...; the center one is 1/2
+        size_t depth = 0;                       // deepest level with analyzers
+        size_t frame = 0;
+        bool extended = false;
+
+        void rebuild(std::vector<float> && frequencies);
+        void prepare(size_t frame);
+        // filters `count` samples of the level above into level.output
+        void decimate(Level & level, const float * samples, size_t count);
+    public:
+        MultirateBank();
+        void add(const std::vector<float> & frequencies);
+        void remove(const std::vector<float> & frequencies);
+        void clear();
+        size_t find(float frequency) const;
+        size_t size() const;
+        const std::vector<float> & frequencies() const;
+        float magnitude(size_t index) const;
+        void setExtended(bool extended);
+        bool isExtended() const;
+        // level a frequency is analyzed at
+        static size_t level(float frequency);
+        template<size_t N>
+        void execute(const std::array<float,N> & samples);
+};
+
+#include "../templates/MultirateBank.tpp"
+#endif
@@ -0,0 +1,73 @@
+#ifndef PERFCOUNTERS_HPP
+#define PERFCOUNTERS_HPP
+
+#include <atomic>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+
+// Hardware counters per DSP stage through perf_event_open. Each thread opens
+// one counter group (cycles, instructions, cache misses, branch misses) the
+// first time it measures, user space only, and the group is read before and
+// after the stage. Off until enable(true); when the kernel refuses the events
+// (perf_event_paranoid, containers, no PMU) available() turns false, reason()
+// says why and scopes cost one branch.
+class PerfCounters{
+    public:
+        enum Counter{
+            CYCLES,
+            INSTRUCTIONS,
+            CACHE_MISSES,
+            BRANCH_MISSES,
+            COUNTERS
+        };
+
+        enum Stage{
+            BANK,       // analyzer banks over one frame
+            BANDS,      // chirp-Z band analyzers
+            HARMONICS,  // harmonic analyzer
+            WBAS,       // wbas.execute
+            SOS,        // Sos filtering
+            STAGES
+        };
+
+        struct Reading{
+            uint64_t values[COUNTERS];
+        };
+
+        // counts one scope into a stage; samples is the input it processed
+        class Scope{
+            private:
+                Stage stage;
+                size_t samples;
+                bool active;
+                Reading start;
+            public:
+                Scope(Stage stage, size_t samples);
+                ~Scope();
+        };
+
+        static void enable(bool on);
+        static bool enabled(){ return on.load(std::memory_order_relaxed); }
+        static bool available();
+        static const char * reason();
+        // current values of the calling thread's group, false when unavailable
+        static bool read(Reading & reading);
+        static void add(Stage stage, const Reading & delta, size_t samples);
+        static uint64_t total(Stage stage, Counter counter);
+        static uint64_t samples(Stage stage);
+        static uint64_t calls(Stage stage);
+        static const char * name(Stage stage);
+        static void clear();
+        static void print(FILE * file, const char * prefix = "");
+    private:
+        struct Totals{
+            std::atomic<uint64_t> values[COUNTERS];
+            std::atomic<uint64_t> samples;
+            std::atomic<uint64_t> calls;
+        };
+        static std::atomic<bool> on;
+        static Totals totals[STAGES];
+};
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef REALTIME_HPP
+#define REALTIME_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <sched.h>
+
+// Opt-in realtime setup for the thread that captures and analyzes. Every
+// step is tried on its own and a refused one leaves the default in place
+// (no privileges, RLIMIT_MEMLOCK, unknown cpu); the returned lines say what
+// was applied and what was not, for the caller to log.
+class Realtime{
+    public:
+        struct Profile{
+            std::vector<int> cpus;          // affinity, empty keeps the inherited one
+            int policy = SCHED_OTHER;       // SCHED_FIFO or SCHED_RR to ask for realtime
+            int priority = 10;              // clamped to the policy range
+            bool lock_memory = false;       // mlockall, prefaults everything mapped so far
+            bool flush_denormals = false;   // FTZ/DAZ, decaying IIR states in silence stay fast
+            size_t stack = 0;               // bytes of stack to prefault
+        };
+
+        // process wide part: memory locking
+        static std::vector<std::string> applyProcess(const Profile & profile);
+        // calling thread part: affinity, scheduling, FP mode, stack
+        static std::vector<std::string> applyThread(const Profile & profile);
+        // "fifo", "rr" or "other", -1 otherwise
+        static int policy(const std::string & name);
+};
+
+#endif
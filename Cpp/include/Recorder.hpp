@@ -2,6 +2,7 @@
 #define RECORDER_hPP
 
 #include <array>
+#include <cstdint>
 #include <mutex>
 #include <thread>
 #include <string>
@@ -11,6 +12,8 @@
 #include <condition_variable>
 
 #include "Constants.hpp"
+#include "Telemetry.hpp"
+#include "Trace.hpp"
 
 template<size_t N>
 class Recorder{
@@ -25,6 +28,7 @@ class Recorder{
         void record(std::array<float,N> & frame);
         void clear();
         void reset(const std::string & source);
+        uint64_t latency();
 };
 
 #include "../templates/Recorder.tpp"
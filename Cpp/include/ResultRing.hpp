@@ -0,0 +1,113 @@
+#ifndef RESULTRING_HPP
+#define RESULTRING_HPP
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <sys/types.h>
+
+// Shared memory layout (POSIX shm, little endian, 64 byte aligned blocks):
+//
+//     ResultRingHeader
+//     float frequencies[analyzers]            (padded to 64 bytes)
+//     slot[slots], slot_size bytes each:
+//         ResultSlot
+//         float magnitudes[analyzers]        (padded to 64 bytes)
+//
+// Each slot is a seqlock: the writer marks it odd while filling it and
+// stores 2 * (frame + 1) once the frame is complete. Readers check the
+// sequence before and after touching the slot, no syscalls involved.
+//
+// A new writer never reuses a segment: it unlinks the name and creates a
+// fresh one, so mapped readers keep the old memory (marked closed) and
+// reopen() onto the new one when replaced() tells them to.
+
+constexpr uint32_t RESULT_RING_MAGIC = 0x52534142;    // "BASR"
+constexpr uint32_t RESULT_RING_VERSION = 1;
+
+struct ResultRingHeader{
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    uint32_t analyzers;
+    uint32_t slots;
+    uint32_t slot_size;
+    uint32_t frequencies_offset;
+    uint32_t slots_offset;
+    std::atomic<uint32_t> closed;                     // nonzero once the writer is gone
+    std::atomic<uint64_t> head;                       // number of published frames
+};
+
+struct ResultSlot{
+    std::atomic<uint64_t> sequence;
+    uint64_t timestamp;                               // ns since epoch
+    float peak_frequency;
+    float peak_magnitude;
+};
+
+static_assert(sizeof(ResultRingHeader) == 40);
+static_assert(sizeof(ResultSlot) == 24);
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+class ResultRingWriter{
+    private:
+        std::string name;
+        uint8_t * memory = nullptr;
+        size_t length = 0;
+        ResultRingHeader * header = nullptr;
+        dev_t device = 0;
+        ino_t inode = 0;
+        uint64_t frame = 0;
+    public:
+        ResultRingWriter(const std::string & name, const std::vector<float> & frequencies, size_t slots);
+        ~ResultRingWriter();
+        ResultRingWriter(const ResultRingWriter &) = delete;
+        ResultRingWriter & operator=(const ResultRingWriter &) = delete;
+        void publish(uint64_t timestamp, std::pair<float,float> peak, const float * magnitudes);
+};
+
+class ResultRingReader{
+    private:
+        std::string name;
+        const uint8_t * memory = nullptr;
+        size_t length = 0;
+        const ResultRingHeader * header = nullptr;
+        dev_t device = 0;
+        ino_t inode = 0;
+        uint64_t cursor = 0;
+        uint64_t lost = 0;
+        const ResultSlot * slot(uint64_t sequence) const;
+    public:
+        // Points straight into the mapping, only valid while consistent() holds
+        struct Frame{
+            uint64_t sequence;
+            uint64_t timestamp;
+            float peak_frequency;
+            float peak_magnitude;
+            const float * magnitudes;
+        };
+
+        ResultRingReader(const std::string & name);
+        ~ResultRingReader();
+        ResultRingReader(const ResultRingReader &) = delete;
+        ResultRingReader & operator=(const ResultRingReader &) = delete;
+
+        size_t analyzers() const;
+        size_t slots() const;
+        const float * frequencies() const;
+        uint64_t head() const;
+
+        // true once the writer closed the ring or another one took the name
+        bool replaced() const;
+        // maps the segment now behind the name, throws while it is not ready
+        void reopen();
+
+        bool acquire(uint64_t sequence, Frame & frame) const;
+        bool consistent(const Frame & frame) const;
+        bool next(Frame & frame);
+        uint64_t skipped() const;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <functional>
+
+#include "BackEnd.hpp"
+#include "Realtime.hpp"
+
+// One analysis frame: magnitudes of every analyzer (ascending frequency) and the peak estimate
+struct Analysis{
+    uint64_t sequence = 0;
+    uint64_t timestamp = 0;                           // ns since epoch
+    uint64_t captured = 0;                            // monotonic ns, see BackEnd::captureTime
+    uint64_t published = 0;                           // monotonic ns
+    std::pair<float,float> peak;
+    std::vector<float> frequencies;
+    std::vector<float> magnitudes;
+    std::vector<Band> bands;                          // band analyzers, creation order
+    uint64_t band_generation = 0;                     // band set the results belong to, see BackEnd::createBand
+    Harmonics harmonics;                              // empty magnitudes when disabled
+};
+
+// Runs capture + analysis on its own thread at capture rate. Results are
+// queued (the oldest are dropped when the consumer falls QUEUE frames
+// behind) and notify() is called after each publish so a GUI can sleep
+// until there is something new to draw.
+class Scheduler{
+    private:
+        static constexpr size_t QUEUE = 64;
+
+        static std::thread worker;
+        static std::atomic<bool> running;
+        static std::function<void()> notify;
+
+        static std::mutex lock;
+        static std::array<Analysis,QUEUE> queue;
+        static std::array<Analysis,QUEUE> consumed;
+        static size_t head;
+        static size_t count;
+        static uint64_t dropped;
+        static Deadline monitor;
+        static Realtime::Profile profile;
+
+        static void work();
+    public:
+        // applied by start() (memory) and by the analysis thread itself, before its first frame
+        static void setRealtime(const Realtime::Profile & profile);
+        static void start(std::function<void()> notify);
+        static void stop();
+        static void addFrequency(float frequency);
+        static void removeFrequency(float frequency);
+        // low priority analyzers run less often when the deadline policy degrades; adding
+        // an existing frequency again moves it between priorities
+        static void addFrequencies(const std::vector<float>& frequencies, bool low_priority = false);
+        static void removeFrequencies(const std::vector<float>& frequencies);
+        // both return the new band generation, matched against Analysis::band_generation
+        static uint64_t addBand(float start, float stop, size_t bins);
+        static uint64_t removeBand(size_t index);
+        static void setHarmonics(float fundamental, size_t count, bool track);
+        static uint64_t drops();
+        // per frame analysis time against the frame period, and the adaptive quality policy
+        static Deadline & deadline();
+
+        // callback(const Analysis&) for every frame published since the last call, oldest first
+        template<typename F>
+        static size_t drain(F callback);
+};
+
+#include "../templates/Scheduler.tpp"
+#endif
@@ -0,0 +1,116 @@
+#ifndef SOCKETSERVER_HPP
+#define SOCKETSERVER_HPP
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+// Stream protocol (SOCK_STREAM unix socket, native byte order):
+//
+//     SocketHello, float frequencies[analyzers]       once, on connection
+//     SocketBatch, frames * (SocketFrame, float magnitudes[analyzers])
+//
+// Batches carry the sequence number of their first frame, a gap between
+// batches means the client was too slow and whole batches were dropped.
+// Frames are packed: with an odd analyzer count every other SocketFrame
+// sits on a 4 byte boundary only, so it is copied out rather than cast.
+
+constexpr uint32_t SOCKET_HELLO_MAGIC = 0x48534142;   // "BASH"
+constexpr uint32_t SOCKET_BATCH_MAGIC = 0x42534142;   // "BASB"
+constexpr uint32_t SOCKET_VERSION = 1;
+
+struct SocketHello{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t analyzers;
+    uint32_t batch;
+};
+
+struct SocketBatch{
+    uint32_t magic;
+    uint32_t frames;
+    uint64_t sequence;
+};
+
+struct SocketFrame{
+    uint64_t timestamp;                               // ns since epoch
+    float peak_frequency;
+    float peak_magnitude;
+};
+
+static_assert(sizeof(SocketHello) == 16);
+static_assert(sizeof(SocketBatch) == 16);
+static_assert(sizeof(SocketFrame) == 16);
+
+class SocketServer{
+    private:
+        using Buffer = std::vector<uint8_t>;
+
+        struct Client{
+            int descriptor;
+            size_t offset;                            // bytes of pending.front() already sent
+            std::deque<std::shared_ptr<const Buffer>> pending;
+        };
+
+        std::string path;
+        int listener = -1;
+        size_t analyzers;
+        size_t batch;
+        size_t queue;
+        size_t frame_size;
+
+        uint64_t sequence = 0;
+        size_t filled = 0;
+        uint64_t dropped = 0;
+        std::shared_ptr<Buffer> current;
+        std::shared_ptr<const Buffer> hello;
+        std::vector<std::shared_ptr<Buffer>> pool;
+        std::vector<Client> clients;
+
+        std::shared_ptr<Buffer> acquire();
+        void accept();
+        bool flush(Client & client);
+        void dispatch();
+    public:
+        SocketServer(const std::string & path, const std::vector<float> & frequencies, size_t batch, size_t queue);
+        ~SocketServer();
+        SocketServer(const SocketServer &) = delete;
+        SocketServer & operator=(const SocketServer &) = delete;
+
+        void publish(uint64_t timestamp, std::pair<float,float> peak, const float * magnitudes);
+        size_t connections() const;
+        uint64_t drops() const;
+};
+
+class SocketClient{
+    private:
+        int descriptor = -1;
+        std::vector<float> frequency_list;
+        size_t frames_per_batch;
+        size_t frame_size;
+        std::vector<uint8_t> buffer;
+        uint64_t expected = 0;
+        uint64_t lost = 0;
+        bool synchronized = false;
+        bool read(void * data, size_t size);
+    public:
+        SocketClient(const std::string & path);
+        ~SocketClient();
+        SocketClient(const SocketClient &) = delete;
+        SocketClient & operator=(const SocketClient &) = delete;
+
+        size_t analyzers() const;
+        const std::vector<float> & frequencies() const;
+        size_t batch() const;
+
+        // Blocks for the next batch, false once the server is gone
+        bool receive(SocketBatch & header);
+        SocketFrame frame(size_t index) const;
+        const float * magnitudes(size_t index) const;
+        uint64_t skipped() const;
+};
+
+#endif
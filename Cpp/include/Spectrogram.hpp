@@ -0,0 +1,30 @@
+#ifndef SPECTROGRAM_HPP
+#define SPECTROGRAM_HPP
+
+#include <vector>
+#include <cstddef>
+
+// Magnitude history of every analyzer, one row per frequency (ascending),
+// one column per analysis frame. Columns are column major and stored twice
+// (slot i and i + columns) so the latest `columns` frames are always one
+// contiguous block, ready for ImPlot::PlotHeatmap with ImPlotHeatmapFlags_ColMajor.
+// push() writes a single column, setFrequencies() is the only O(rows * columns)
+// operation and runs when the analyzer set changes.
+class Spectrogram{
+    private:
+        size_t columns;
+        size_t head = 0;
+        std::vector<float> frequency_list;
+        std::vector<float> memory;
+    public:
+        Spectrogram(size_t columns);
+        void setFrequencies(const std::vector<float> & frequencies);
+        void push(const float * column);
+        void clear();
+        size_t rows() const;
+        size_t width() const;
+        const std::vector<float> & frequencies() const;
+        const float * data() const;
+};
+
+#endif
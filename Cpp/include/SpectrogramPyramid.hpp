@@ -0,0 +1,62 @@
+#ifndef SPECTROGRAMPYRAMID_HPP
+#define SPECTROGRAMPYRAMID_HPP
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// Long term spectrogram store. Level 0 keeps the last `columns` analysis
+// frames as they arrive, level k keeps `columns` columns that each reduce
+// 2^k frames, once as the maximum and once as the mean of the two level
+// k - 1 columns below it. push() writes level 0 and completes at most one
+// column per level, so the cost per frame is O(rows) amortized. Each level
+// is a column major ring; all levels share one mapping, anonymous by
+// default or backed by `path` so the kernel can page it out to disk.
+// Anonymous stores keep at most `budget` bytes: with many rows each level
+// gets fewer columns (never less than two), a file keeps all `columns`.
+// Changing the row count starts a new, empty store.
+//
+// Coordinates follow the history plots: x is in frames ago, the newest
+// frame spans [-1, 0).
+class SpectrogramPyramid{
+    public:
+        struct Window{
+            size_t level;
+            uint64_t first;
+            size_t count;
+            double xmin;
+            double xmax;
+        };
+    private:
+        size_t capacity;                // columns asked for
+        size_t columns;                 // columns in use, capacity or what the budget allows
+        size_t depth;
+        size_t budget;
+        std::string path;
+        size_t length = 0;
+        float * memory = nullptr;
+        size_t height = 0;
+        uint64_t total = 0;
+
+        float * column(size_t level, bool mean, uint64_t index) const;
+        void map();
+        void unmap();
+    public:
+        SpectrogramPyramid(size_t columns, size_t levels, size_t budget, const std::string & path = "");
+        ~SpectrogramPyramid();
+        SpectrogramPyramid(const SpectrogramPyramid &) = delete;
+        SpectrogramPyramid & operator=(const SpectrogramPyramid &) = delete;
+
+        void setRows(size_t rows);
+        void setPath(const std::string & path);
+        void push(const float * column);
+        void clear();
+        size_t rows() const;
+        size_t width() const;
+        size_t levels() const;
+        uint64_t frames() const;
+        Window locate(double from, double to, double pixels) const;
+        void copy(const Window & window, bool mean, float * destination) const;
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef SPECTROGRAMTEXTURE_HPP
+#define SPECTROGRAMTEXTURE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// GPU side of the spectrogram. Magnitudes live in an R32F texture used as
+// a circular image, one texture row per analysis frame (x = frequency row,
+// y = time slot), so a new frame is a single glTexSubImage2D of one row.
+// render() draws one quad into an RGBA image through a shader that applies
+// the wrap offset and the colormap lookup; the result goes to ImPlot::PlotImage.
+// CPU cost per frame does not depend on the history length.
+// Needs a current GL 3.0 context, call initialize()/cleanup() around it.
+class SpectrogramTexture{
+    private:
+        unsigned int program = 0;
+        unsigned int vertex_array = 0;
+        unsigned int framebuffer = 0;
+        unsigned int magnitudes = 0;
+        unsigned int colormap = 0;
+        unsigned int image = 0;
+        int offset_location = -1;
+        int minimum_location = -1;
+        int maximum_location = -1;
+
+        size_t rows = 0;
+        size_t columns = 0;
+        size_t head = 0;
+        bool dirty = true;
+        float minimum = 0;
+        float maximum = 0;
+    public:
+        bool initialize();
+        void cleanup();
+        bool valid() const;
+        void setColormap(const uint32_t * colors, size_t count);
+        void resize(size_t rows, size_t columns, const float * data);
+        void push(const float * column);
+        uint64_t render(float minimum, float maximum);
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef SPECTRUMBANK_HPP
+#define SPECTRUMBANK_HPP
+
+#include <array>
+#include <vector>
+#include <cstddef>
+
+#include "GoertzelBank.hpp"
+#include "FFTBank.hpp"
+#include "MultirateBank.hpp"
+#include "Constants.hpp"
+
+// The analyzer bank BackEnd uses: the GoertzelBank interface over engines
+// holding the same analyzers. AUTO runs the FFT bank from CROSSOVER
+// analyzers up (where bas-bench measures it getting cheaper than the
+// Goertzel bank, see fft_crossover), unless the analyzers sit closer than
+// the FFT's interpolation grid: that detail only the exact recurrences give.
+// MULTIRATE is only ever asked for, its deep levels trade latency for cost.
+class SpectrumBank{
+    public:
+        enum Engine{
+            AUTO,
+            GOERTZEL,
+            FFT,
+            MULTIRATE
+        };
+        static constexpr size_t CROSSOVER = 64;
+    private:
+        GoertzelBank goertzel;
+        FFTBank fft;
+        MultirateBank multirate;
+        Engine requested = AUTO;
+        Engine active = GOERTZEL;
+        bool degraded = false;
+        bool stale = true;                  // active engine has not run since it or the analyzers changed
+
+        void choose();
+        Engine pick() const;
+    public:
+        void add(const std::vector<float> & frequencies);
+        void remove(const std::vector<float> & frequencies);
+        void clear();
+        size_t find(float frequency) const;
+        size_t size() const;
+        const std::vector<float> & frequencies() const;
+        float magnitude(size_t index) const;
+        void setEngine(Engine engine);
+        // under load: the FFT whatever the spacing, unless MULTIRATE was asked for
+        void setDegraded(bool degraded);
+        // long integration on the decimated levels of MULTIRATE, see MultirateBank
+        void setExtended(bool extended);
+        // GOERTZEL, FFT or MULTIRATE, what execute() runs
+        Engine engine() const;
+        // magnitude() is not yet from the active engine over the current analyzers,
+        // a bank that skips frames must execute() before it is read again
+        bool isStale() const;
+        template<size_t N>
+        void execute(const std::array<float,N> & samples);
+};
+
+#include "../templates/SpectrumBank.tpp"
+#endif
@@ -0,0 +1,52 @@
+#ifndef TELEMETRY_HPP
+#define TELEMETRY_HPP
+
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+
+#include "Histogram.hpp"
+
+// Process wide timing of the pipeline, one histogram per metric. The capture
+// and analysis stages are recorded by BackEnd/Scheduler, the draw side by
+// whoever renders. Durations and latencies are in nanoseconds.
+class Telemetry{
+    public:
+        enum Metric{
+            READ,               // blocked in the capture read
+            COPY,               // captured frame copied out of the recorder
+            SOURCE_LATENCY,     // audio waiting in the source before the read, as reported by PulseAudio
+            BANK,               // foreground and background analyzer banks over one frame
+            BANDS,              // chirp-Z band analyzers
+            HARMONICS,          // harmonic analyzer
+            WBAS,               // wbas.execute
+            PUBLISH,            // results handed to the consumers (GUI queue, shm, socket, archive)
+            ANALYSIS_CPU,       // analysis thread CPU time per frame
+            PUBLISH_TO_DRAW,    // result published -> frame drawn
+            AUDIO_TO_PIXEL,     // sample captured -> frame drawn
+            RENDER_CPU,         // render thread CPU time per frame
+            METRICS
+        };
+
+        // times one scope into a metric
+        class Scope{
+            private:
+                Metric metric;
+                uint64_t start;
+            public:
+                Scope(Metric metric);
+                ~Scope();
+        };
+
+        static uint64_t now();
+        static uint64_t threadTime();
+        static void record(Metric metric, uint64_t value);
+        static const Histogram & histogram(Metric metric);
+        static const char * name(Metric metric);
+        static void clear();
+        static void print(FILE * file, const char * prefix = "");
+    private:
+        static Histogram histograms[METRICS];
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <atomic>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Timeline of the pipeline stages in Chrome trace-event format, for
+// ui.perfetto.dev or chrome://tracing. Each thread appends complete events to
+// its own fixed ring, with no lock and no allocation after the first one;
+// write() reads what the threads published so far. A full ring overwrites its
+// oldest events, so the trace always ends at the latest frames. Events are
+// stamped with the TSC where there is one and converted to CLOCK_MONOTONIC
+// when written. The TRACE_SCOPE macro only expands when BAS_TRACE is defined
+// (cmake -DTRACE=ON), and even then records nothing until enable(true).
+class Trace{
+    public:
+        static constexpr size_t CAPACITY = 1 << 16;    // events per thread
+
+        struct Event{
+            const char * name;      // string literal, only the pointer is kept
+            uint64_t start;         // ticks()
+            uint64_t duration;      // ticks()
+        };
+
+        class Scope{
+            private:
+                const char * name;
+                uint64_t start;
+            public:
+                Scope(const char * name) : name(name), start(enabled() ? ticks() : 0){}
+                ~Scope(){
+                    if(start)
+                        record(name, start, ticks() - start);
+                }
+        };
+
+        static void enable(bool on);
+        static bool enabled(){ return on.load(std::memory_order_relaxed); }
+        // labels the calling thread in the timeline
+        static void thread(const char * name);
+        static void record(const char * name, uint64_t start, uint64_t duration);
+        // events held, and older ones overwritten since
+        static size_t events();
+        static size_t dropped();
+        static void write(FILE * file);
+        static bool write(const std::string & path);
+        // cheapest monotonic timestamp available, unit fixed per machine
+        static uint64_t ticks(){
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return now();
+#endif
+        }
+    private:
+        static uint64_t now();
+        static std::atomic<bool> on;
+};
+
+#ifdef BAS_TRACE
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) Trace::Scope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#endif
+
+#endif
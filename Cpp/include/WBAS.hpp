@@ -9,6 +9,8 @@
 
 #include "Filter.hpp"
 #include "Constants.hpp"
+#include "Trace.hpp"
+#include "PerfCounters.hpp"
 
 // octave:1> pkg load signal
 // octave:2> [b, a] = ellip(4, 0.5, 20, 0.25);
@@ -25,6 +27,7 @@ class WBAS {
         void filter(const std::array<float,N>& samples, std::array<float,N>& filtered, size_t step);
         void upperband(const std::array<float,N>& wholeband, const std::array<float,N>& lowerband, std::array<float,N>& upperband, size_t step);
         Sos<2,float,float,float> lpf;
+        size_t depth = 0;
     public:
         // WBAS() : lpf({
         //     {{0.120960, -0.019523, 0.120960},{-1.152464, 0.462928}},
@@ -50,6 +53,8 @@ class WBAS {
             }}
         ){};
         float execute(const std::array<float,N> & samples);
+        //halvings of the band, 0 (default) keeps going until the step reaches N
+        void set(size_t depth);
 };
 
 #include "../templates/WBAS.tpp"
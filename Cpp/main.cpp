@@ -1,5 +1,7 @@
 #include "include/FrontEnd.hpp"
 #include "include/BackEnd.hpp"
+#include "include/Scheduler.hpp"
+#include "include/Realtime.hpp"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -10,6 +12,14 @@
 #include "imgui/imgui.h"
 
 #include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <thread>
+#include <chrono>
+
+// Sem eventos nem resultados novos, redesenha ao menos a cada IDLE_TIMEOUT segundos
+static constexpr double IDLE_TIMEOUT = 0.5;
 
 // Callback para tratamento de erros do GLFW
 static void glfw_error_callback(int error, const char* description)
@@ -17,7 +27,42 @@ static void glfw_error_callback(int error, const char* description)
     fprintf(stderr, "Glfw Error %d: %s\n", error, description);
 }
 
-int main(){
+int main(int argc, char** argv){
+    // Taxa máxima de quadros: --max-fps N (padrão 60)
+    // Arquivo da pirâmide do espectrograma: --spectrogram-spill CAMINHO (padrão: só memória)
+    // Linha do tempo das etapas: --trace CAMINHO (JSON do Chrome, gravado ao sair)
+    // Perfil de tempo real da análise: --realtime fifo|rr|other e --realtime-cpus 2,3
+    double max_fps = 60.0;
+    const char* spectrogram_spill = nullptr;
+    const char* trace = nullptr;
+    Realtime::Profile realtime;
+    bool use_realtime = false;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--max-fps") == 0)
+            max_fps = std::max(1.0, std::atof(argv[i + 1]));
+        else if (std::strcmp(argv[i], "--spectrogram-spill") == 0)
+            spectrogram_spill = argv[i + 1];
+        else if (std::strcmp(argv[i], "--trace") == 0)
+            trace = argv[i + 1];
+        else if (std::strcmp(argv[i], "--realtime") == 0) {
+            use_realtime = true;
+            realtime.policy = Realtime::policy(argv[i + 1]);
+            if (realtime.policy < 0) {
+                fprintf(stderr, "--realtime: use fifo, rr ou other\n");
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--realtime-cpus") == 0) {
+            use_realtime = true;
+            for (const char* cpu = argv[i + 1]; *cpu; ) {
+                char* end;
+                realtime.cpus.push_back(std::strtol(cpu, &end, 10));
+                cpu = *end == ',' ? end + 1 : end + std::strlen(end);
+            }
+        }
+    }
+    const double frame_period = 1.0 / max_fps;
+
     // Configurar callback de erro do GLFW
     glfwSetErrorCallback(glfw_error_callback);
 
@@ -46,11 +91,33 @@ int main(){
     BackEnd::initialize();
 
     // Inicializar o frontend
+    if (spectrogram_spill)
+        FrontEnd::Application::setSpectrogramSpill(spectrogram_spill);
+    if (trace)
+        FrontEnd::Application::setTracePath(trace);
     FrontEnd::Application::initialize(window);
 
-    // Loop principal
+    // Análise na própria thread, acorda a interface quando publica resultados
+    if (use_realtime) {
+        realtime.lock_memory = true;
+        realtime.flush_denormals = true;
+        realtime.stack = 256 * 1024;
+        Scheduler::setRealtime(realtime);
+    }
+    Scheduler::start([]() { glfwPostEmptyEvent(); });
+
+    // Loop principal: dorme até haver evento de usuário ou resultado novo
+    double last_frame = 0.0;
     while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
+        glfwWaitEventsTimeout(IDLE_TIMEOUT);
+
+        // Limita a taxa de quadros
+        double elapsed = glfwGetTime() - last_frame;
+        if (elapsed < frame_period) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(frame_period - elapsed));
+            glfwPollEvents();
+        }
+        last_frame = glfwGetTime();
 
         // Renderizar o frontend
         FrontEnd::Application::render(window);
@@ -58,6 +125,9 @@ int main(){
         glfwSwapBuffers(window);
     }
 
+    // Para a thread de análise
+    Scheduler::stop();
+
     // Limpeza do frontend
     FrontEnd::Application::cleanup();
 
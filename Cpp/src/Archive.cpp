@@ -0,0 +1,248 @@
+#include "Archive.hpp"
+
+#include <cmath>
+#include <cerrno>
+#include <limits>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+static constexpr size_t PAGE = 4096;
+static constexpr uint64_t MAXIMUM_DELTA = numeric_limits<uint32_t>::max() * 1000ull;
+
+static size_t align(size_t size){
+    return (size + PAGE - 1) / PAGE * PAGE;
+}
+
+ArchiveWriter::ArchiveWriter(const string & path, const vector<float> & frequencies, size_t rows){
+    if(rows == 0)
+        throw invalid_argument("ArchiveWriter.constructor: blocks need at least one row");
+
+    header.magic = ARCHIVE_MAGIC;
+    header.version = ARCHIVE_VERSION;
+    header.columns = frequencies.size();
+    header.rows = rows;
+    header.block_size = align(sizeof(ArchiveBlock) + 2 * frequencies.size() * sizeof(float) + rows * sizeof(uint32_t) + frequencies.size() * rows * sizeof(uint16_t));
+    header.data_offset = align(sizeof(ArchiveHeader) + frequencies.size() * sizeof(float));
+
+    times.resize(rows);
+    values.resize(frequencies.size() * rows);
+    block.resize(header.block_size);
+
+    try{
+        open(path, frequencies);
+    }
+    catch(...){
+        if(data >= 0)
+            close(data);
+        if(index >= 0)
+            close(index);
+        throw;
+    }
+}
+
+void ArchiveWriter::open(const string & path, const vector<float> & frequencies){
+    data = ::open(path.data(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    index = ::open((path + ".idx").data(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if(data < 0 || index < 0)
+        throw runtime_error("ArchiveWriter.open: " + path + ": " + strerror(errno));
+
+    struct stat status;
+    if(fstat(data, &status) < 0)
+        throw runtime_error("ArchiveWriter.open: " + path + ": " + strerror(errno));
+
+    if(status.st_size == 0){
+        vector<uint8_t> head(header.data_offset, 0);
+        memcpy(head.data(), &header, sizeof(header));
+        memcpy(head.data() + sizeof(header), frequencies.data(), frequencies.size() * sizeof(float));
+        if(pwrite(data, head.data(), head.size(), 0) != (ssize_t)head.size() || ftruncate(index, 0) < 0)
+            throw runtime_error("ArchiveWriter.open: " + path + ": " + strerror(errno));
+        return;
+    }
+
+    //appending to an existing archive, the layout must match
+    ArchiveHeader existing;
+    vector<float> columns(frequencies.size());
+    if(pread(data, &existing, sizeof(existing), 0) != sizeof(existing)
+    || existing.magic != ARCHIVE_MAGIC || existing.version != ARCHIVE_VERSION
+    || existing.columns != header.columns || existing.rows != header.rows
+    || pread(data, columns.data(), columns.size() * sizeof(float), sizeof(existing)) != (ssize_t)(columns.size() * sizeof(float))
+    || columns != frequencies)
+        throw invalid_argument("ArchiveWriter.open: " + path + " holds a different layout, refusing to append");
+
+    if(fstat(index, &status) < 0)
+        throw runtime_error("ArchiveWriter.open: " + path + ".idx: " + strerror(errno));
+    blocks = status.st_size / sizeof(ArchiveIndex);
+
+    //a block without its index entry was torn by a crash, overwrite it
+    if(ftruncate(data, header.data_offset + blocks * header.block_size) < 0 || ftruncate(index, blocks * sizeof(ArchiveIndex)) < 0)
+        throw runtime_error("ArchiveWriter.open: " + path + ": " + strerror(errno));
+
+    if(blocks){
+        ArchiveIndex last;
+        if(pread(index, &last, sizeof(last), (blocks - 1) * sizeof(ArchiveIndex)) != sizeof(last))
+            throw runtime_error("ArchiveWriter.open: " + path + ".idx: " + strerror(errno));
+        last_time = last.last_time;
+    }
+}
+
+ArchiveWriter::~ArchiveWriter(){
+    try{
+        flush();
+    }
+    catch(const exception&){
+    }
+    close(data);
+    close(index);
+}
+
+void ArchiveWriter::append(uint64_t timestamp, const float * magnitudes){
+    //keep time monotonic so the index stays sorted
+    timestamp = max(timestamp, last_time);
+
+    if(filled == header.rows || (filled && timestamp - times[0] > MAXIMUM_DELTA))
+        flush();
+
+    times[filled] = timestamp;
+    for(size_t column = 0; column < header.columns; column++)
+        values[column * header.rows + filled] = magnitudes[column];
+    filled++;
+    last_time = timestamp;
+}
+
+void ArchiveWriter::flush(){
+    if(filled == 0)
+        return;
+
+    fill(block.begin(), block.end(), 0);
+    ArchiveBlock description = {times[0], (uint32_t)filled, 0};
+    memcpy(block.data(), &description, sizeof(description));
+
+    float * minimum = reinterpret_cast<float*>(block.data() + sizeof(ArchiveBlock));
+    float * scale = minimum + header.columns;
+    uint32_t * time = reinterpret_cast<uint32_t*>(scale + header.columns);
+    uint16_t * quantized = reinterpret_cast<uint16_t*>(time + header.rows);
+
+    for(size_t row = 0; row < filled; row++)
+        time[row] = (times[row] - times[0]) / 1000;
+
+    for(size_t column = 0; column < header.columns; column++){
+        const float * source = values.data() + column * header.rows;
+        auto [lowest, highest] = minmax_element(source, source + filled);
+        minimum[column] = *lowest;
+        scale[column] = (*highest - *lowest) / numeric_limits<uint16_t>::max();
+
+        uint16_t * destination = quantized + column * header.rows;
+        if(scale[column] > 0)
+            for(size_t row = 0; row < filled; row++)
+                destination[row] = lround((source[row] - minimum[column]) / scale[column]);
+    }
+
+    ArchiveIndex entry = {times[0], times[filled - 1], (uint32_t)filled, 0};
+    if(pwrite(data, block.data(), block.size(), header.data_offset + blocks * header.block_size) != (ssize_t)block.size()
+    || pwrite(index, &entry, sizeof(entry), blocks * sizeof(ArchiveIndex)) != sizeof(entry))
+        throw runtime_error("ArchiveWriter.flush: " + string(strerror(errno)));
+
+    blocks++;
+    filled = 0;
+}
+
+ArchiveReader::ArchiveReader(const string & path) : path(path){
+    refresh();
+}
+
+ArchiveReader::~ArchiveReader(){
+    unmap();
+}
+
+void ArchiveReader::unmap(){
+    if(data)
+        munmap(const_cast<uint8_t*>(data), data_length);
+    if(entries)
+        munmap(const_cast<ArchiveIndex*>(entries), index_length);
+    data = nullptr;
+    entries = nullptr;
+    count = 0;
+}
+
+void ArchiveReader::refresh(){
+    unmap();
+
+    int descriptors[2] = {
+        open(path.data(), O_RDONLY | O_CLOEXEC),
+        open((path + ".idx").data(), O_RDONLY | O_CLOEXEC)
+    };
+    size_t lengths[2] = {0, 0};
+    void * mappings[2] = {nullptr, nullptr};
+
+    for(size_t i = 0; i < 2; i++){
+        struct stat status;
+        if(descriptors[i] >= 0 && fstat(descriptors[i], &status) == 0 && status.st_size > 0){
+            lengths[i] = status.st_size;
+            mappings[i] = mmap(nullptr, lengths[i], PROT_READ, MAP_SHARED, descriptors[i], 0);
+            if(mappings[i] == MAP_FAILED)
+                mappings[i] = nullptr;
+        }
+        if(descriptors[i] >= 0)
+            close(descriptors[i]);
+    }
+
+    data = static_cast<const uint8_t*>(mappings[0]);
+    data_length = lengths[0];
+    entries = static_cast<const ArchiveIndex*>(mappings[1]);
+    index_length = lengths[1];
+
+    if(!data || data_length < sizeof(ArchiveHeader)){
+        unmap();
+        throw runtime_error("ArchiveReader.refresh: could not map " + path);
+    }
+
+    memcpy(&header, data, sizeof(header));
+    if(header.magic != ARCHIVE_MAGIC || header.version != ARCHIVE_VERSION || data_length < header.data_offset){
+        unmap();
+        throw runtime_error("ArchiveReader.refresh: " + path + " is not a version " + to_string(ARCHIVE_VERSION) + " archive");
+    }
+
+    //queries jump around, read ahead would touch blocks nobody asked for
+    madvise(const_cast<uint8_t*>(data), data_length, MADV_RANDOM);
+
+    count = min(index_length / sizeof(ArchiveIndex), (data_length - header.data_offset) / header.block_size);
+}
+
+const uint8_t * ArchiveReader::block(size_t number) const{
+    return data + header.data_offset + number * header.block_size;
+}
+
+size_t ArchiveReader::columns() const{
+    return header.columns;
+}
+
+size_t ArchiveReader::blocks() const{
+    return count;
+}
+
+const float * ArchiveReader::frequencies() const{
+    return reinterpret_cast<const float*>(data + sizeof(ArchiveHeader));
+}
+
+size_t ArchiveReader::column(float frequency) const{
+    size_t nearest = 0;
+    for(size_t i = 1; i < header.columns; i++)
+        if(fabs(frequencies()[i] - frequency) < fabs(frequencies()[nearest] - frequency))
+            nearest = i;
+    return nearest;
+}
+
+uint64_t ArchiveReader::begin() const{
+    return count ? entries[0].first_time : 0;
+}
+
+uint64_t ArchiveReader::end() const{
+    return count ? entries[count - 1].last_time + 1 : 0;
+}
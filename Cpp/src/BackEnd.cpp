@@ -1,13 +1,27 @@
 #include "../include/BackEnd.hpp"
+#include "../include/FlightRecorder.hpp"
 
 using namespace std;
 
 Recorder<BUFFER_SIZE> BackEnd::recorder("");
 array<float,BUFFER_SIZE> BackEnd::frame;
-unordered_map<float,Goertzel> BackEnd::analyzers;
+SpectrumBank BackEnd::analyzers;
+SpectrumBank BackEnd::background;
+size_t BackEnd::background_interval = 1;
+vector<ChirpZ> BackEnd::bands;
+uint64_t BackEnd::band_generation = 0;
+HarmonicAnalyzer BackEnd::harmonics;
+bool BackEnd::track_peak = false;
+uint64_t BackEnd::frames = 0;
+bool BackEnd::analyzed = false;
 float BackEnd::normalization;
 BAS BackEnd::bas(0,8e3,10,1,100);
 WBAS<BUFFER_SIZE> BackEnd::wbas;
+FlightRecorder * BackEnd::flight_recorder = nullptr;
+uint64_t BackEnd::capture = 0;
+uint64_t BackEnd::pending_capture = 0;
+mutex BackEnd::analyzers_lock;
+mutex BackEnd::recorder_lock;
 
 atomic<bool> BackEnd::read_names = false;
 pa_mainloop *BackEnd::main_loop = nullptr;
@@ -66,6 +80,7 @@ void BackEnd::setSource(const string & source){
     if(!in_sources)
         return;
     
+    lock_guard<mutex> guard(recorder_lock);
     recorder.reset(source);
 }
 
@@ -96,25 +111,151 @@ void BackEnd::cleanup() {
 }
 
 void BackEnd::createAnalyzer(float frequency){
-    analyzers.try_emplace(frequency,frequency);
+    createAnalyzers({frequency});
 }
 
 void BackEnd::destroyAnalyzer(float frequency){
-    auto match = analyzers.find(frequency);
-    if(match != analyzers.end()){
-        analyzers.erase(match);
+    destroyAnalyzers({frequency});
+}
+
+//the whole list costs a single reallocation of the bank; a frequency lives in one bank only
+void BackEnd::createAnalyzers(const vector<float>& frequencies, bool low_priority){
+    lock_guard<mutex> guard(analyzers_lock);
+    (low_priority ? background : analyzers).add(frequencies);
+    (low_priority ? analyzers : background).remove(frequencies);
+    analyzed = false;
+}
+
+void BackEnd::destroyAnalyzers(const vector<float>& frequencies){
+    lock_guard<mutex> guard(analyzers_lock);
+    analyzers.remove(frequencies);
+    background.remove(frequencies);
+    analyzed = false;
+}
+
+//validated before taking the lock, ChirpZ throws on a bad band
+uint64_t BackEnd::createBand(float start, float stop, size_t bins){
+    ChirpZ band(start, stop, bins);
+    lock_guard<mutex> guard(analyzers_lock);
+    bands.push_back(move(band));
+    analyzed = false;
+    return ++band_generation;
+}
+
+uint64_t BackEnd::destroyBand(size_t index){
+    lock_guard<mutex> guard(analyzers_lock);
+    if(index >= bands.size())
+        throw(out_of_range("BackEnd.destroyBand: no band " + to_string(index) + ", there are " + to_string(bands.size())));
+    bands.erase(bands.begin() + index);
+    return ++band_generation;
+}
+
+//every band, creation order, on the same normalization as the analyzers
+uint64_t BackEnd::queryBands(vector<Band>& results){
+    TRACE_SCOPE("BackEnd::queryBands");
+    lock_guard<mutex> guard(analyzers_lock);
+    analyze();
+
+    results.resize(bands.size());
+    for(size_t i = 0; i < bands.size(); i++){
+        results[i].start = bands[i].start();
+        results[i].stop = bands[i].stop();
+        const vector<float> & magnitudes = bands[i].magnitudes();
+        results[i].magnitudes.resize(magnitudes.size());
+        for(size_t bin = 0; bin < magnitudes.size(); bin++){
+            float magnitude = magnitudes[bin];
+            normalization = normalization > magnitude ? normalization * decay : magnitude;
+            results[i].magnitudes[bin] = magnitude / normalization;
+        }
     }
+    return band_generation;
+}
+
+void BackEnd::setHarmonics(float fundamental, size_t count, bool track){
+    HarmonicAnalyzer analyzer(fundamental, count);
+    lock_guard<mutex> guard(analyzers_lock);
+    harmonics = analyzer;
+    track_peak = track;
+    analyzed = false;
+}
+
+//magnitudes on the shared normalization, the THD from the raw ones
+void BackEnd::queryHarmonics(Harmonics& results){
+    TRACE_SCOPE("BackEnd::queryHarmonics");
+    lock_guard<mutex> guard(analyzers_lock);
+    analyze();
+
+    results.fundamental = harmonics.fundamental();
+    results.thd = harmonics.thd();
+    results.magnitudes.resize(harmonics.harmonics());
+    for(size_t k = 1; k <= harmonics.harmonics(); k++){
+        float magnitude = harmonics.magnitude(k);
+        normalization = normalization > magnitude ? normalization * decay : magnitude;
+        results.magnitudes[k - 1] = magnitude / normalization;
+    }
+}
+
+void BackEnd::setFlightRecorder(FlightRecorder * recorder){
+    flight_recorder = recorder;
 }
 
 void BackEnd::update(){
+    TRACE_SCOPE("BackEnd::update");
+    lock_guard<mutex> guard(recorder_lock);
     recorder.record(frame);
+    uint64_t latency = recorder.latency();
+    Telemetry::record(Telemetry::SOURCE_LATENCY, latency);
+    capture = pending_capture;
+    pending_capture = Telemetry::now() - latency;
+
+    if(flight_recorder)
+        flight_recorder->record(frame.data(), frame.size());
+
+    lock_guard<mutex> analyzers_guard(analyzers_lock);
+    analyzed = false;
+    frames++;
+}
+
+//the first query after a new frame runs the banks, analyzers_lock held;
+//the background bank keeps its previous magnitudes on the frames it skips,
+//unless an engine switch or new analyzers left it without valid ones
+void BackEnd::analyze(){
+    if(analyzed)
+        return;
+    {
+        Telemetry::Scope scope(Telemetry::BANK);
+        PerfCounters::Scope counters(PerfCounters::BANK, frame.size());
+        analyzers.execute(frame);
+        if(background.size() && (background.isStale() || frames % background_interval == 0))
+            background.execute(frame);
+    }
+    if(!bands.empty()){
+        Telemetry::Scope scope(Telemetry::BANDS);
+        PerfCounters::Scope counters(PerfCounters::BANDS, frame.size());
+        for(ChirpZ & band : bands)
+            band.execute(frame);
+    }
+    if(harmonics.harmonics()){
+        Telemetry::Scope scope(Telemetry::HARMONICS);
+        PerfCounters::Scope counters(PerfCounters::HARMONICS, frame.size());
+        harmonics.execute(frame);
+    }
+    analyzed = true;
 }
 
+//per analyzer, too fine grained for the timeline: queryFrequencies is the traced path
 float BackEnd::queryFrequency(float frequency){
-    
-    auto analyzer = analyzers.find(frequency);
-    if (analyzer != analyzers.end()){ 
-        float magnitude = (analyzer->second).execute(frame); 
+    lock_guard<mutex> guard(analyzers_lock);
+    SpectrumBank * bank = &analyzers;
+    size_t analyzer = analyzers.find(frequency);
+    if(analyzer == analyzers.size()){
+        bank = &background;
+        analyzer = background.find(frequency);
+    }
+
+    if (analyzer != bank->size()){ 
+        analyze();
+        float magnitude = bank->magnitude(analyzer);
         normalization = normalization > magnitude ? normalization * decay : magnitude;
         return magnitude / normalization;
     }
@@ -122,12 +263,85 @@ float BackEnd::queryFrequency(float frequency){
         return -1;
 }
 
+//every analyzer, ascending frequency
+void BackEnd::queryFrequencies(vector<float>& frequencies, vector<float>& magnitudes){
+    TRACE_SCOPE("BackEnd::queryFrequencies");
+    lock_guard<mutex> guard(analyzers_lock);
+    analyze();
+
+    //merge of the two sorted banks
+    const vector<float> & foreground_frequencies = analyzers.frequencies();
+    const vector<float> & background_frequencies = background.frequencies();
+    frequencies.resize(analyzers.size() + background.size());
+    magnitudes.resize(frequencies.size());
+    for(size_t i = 0, f = 0, b = 0; i < frequencies.size(); i++){
+        float magnitude;
+        if(b == background.size() || (f < analyzers.size() && foreground_frequencies[f] < background_frequencies[b])){
+            frequencies[i] = foreground_frequencies[f];
+            magnitude = analyzers.magnitude(f++);
+        }
+        else{
+            frequencies[i] = background_frequencies[b];
+            magnitude = background.magnitude(b++);
+        }
+        normalization = normalization > magnitude ? normalization * decay : magnitude;
+        magnitudes[i] = magnitude / normalization;
+    }
+}
+
+void BackEnd::setEngine(SpectrumBank::Engine engine){
+    lock_guard<mutex> guard(analyzers_lock);
+    analyzers.setEngine(engine);
+    background.setEngine(engine);
+    analyzed = false;
+}
+
+//what runs the foreground analyzers now
+SpectrumBank::Engine BackEnd::engine(){
+    lock_guard<mutex> guard(analyzers_lock);
+    return analyzers.engine();
+}
+
+void BackEnd::setExtended(bool extended){
+    lock_guard<mutex> guard(analyzers_lock);
+    analyzers.setExtended(extended);
+    background.setExtended(extended);
+    analyzed = false;
+}
+
+//called by the analysis thread between frames
+void BackEnd::setQuality(const Quality & quality){
+    wbas.set(quality.wbas_depth);
+
+    lock_guard<mutex> guard(analyzers_lock);
+    background_interval = max<size_t>(1, quality.background_interval);
+    analyzers.setDegraded(quality.fft);
+    background.setDegraded(quality.fft);
+}
+
 pair<float,float> BackEnd::maximum(){
     static Goertzel analizer(0.0f);
     // float frequency = bas.execute(frame);
-    float frequency = wbas.execute(frame);
+    float frequency;
+    {
+        Telemetry::Scope scope(Telemetry::WBAS);
+        PerfCounters::Scope counters(PerfCounters::WBAS, frame.size());
+        frequency = wbas.execute(frame);
+    }
     // float magnitude = analizer.execute(frequency,frame); 
     float magnitude = 1;
+
+    //before this frame's analysis when the caller asks for the peak first
+    if(track_peak){
+        lock_guard<mutex> guard(analyzers_lock);
+        if(harmonics.retune(frequency))
+            analyzed = false;
+    }
     normalization = normalization > magnitude ? normalization * decay : magnitude;
     return pair<float,float>(frequency,1);
+}
+
+uint64_t BackEnd::captureTime(){
+    lock_guard<mutex> guard(recorder_lock);
+    return capture;
 }
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "ChirpZ.hpp"
+
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+ChirpZ::ChirpZ(float start, float stop, size_t bins){
+    set(start, stop, bins);
+}
+
+void ChirpZ::set(float start, float stop, size_t bins){
+    if(bins == 0)
+        throw(invalid_argument("ChirpZ.set: a band needs at least one bin"));
+    if(start < 0 || stop > SAMPLE_RATE/2)
+        throw(invalid_argument("ChirpZ.set: the band must lie between 0 and half of the sample rate: " + to_string(SAMPLE_RATE) + " sps"));
+    if(bins > 1 && stop <= start)
+        throw(invalid_argument("ChirpZ.set: stop must be above start"));
+
+    first = start;
+    last = bins > 1 ? stop : start;
+    count = bins;
+    results.assign(bins, 0.0f);
+    if(frame)
+        prepare(frame);
+}
+
+void ChirpZ::prepare(size_t frame){
+    this->frame = frame;
+    size_t length = 1;
+    while(length < frame + count - 1)
+        length <<= 1;
+    fft.resize(length);
+
+    //angles in double, n^2 dw grows far past what a float phase resolves
+    double w0 = 2.0 * M_PI * first / SAMPLE_RATE;
+    double dw = count > 1 ? 2.0 * M_PI * (last - first) / ((count - 1) * double(SAMPLE_RATE)) : 0.0;
+
+    chirp_re.resize(frame);
+    chirp_im.resize(frame);
+    for(size_t n = 0; n < frame; n++){
+        double angle = -fmod(w0 * n + 0.5 * dw * double(n) * n, 2.0 * M_PI);
+        chirp_re[n] = cos(angle);
+        chirp_im[n] = sin(angle);
+    }
+
+    //kernel laid out circularly: k >= 0 from the start, k < 0 from the end
+    kernel_re.assign(length, 0.0f);
+    kernel_im.assign(length, 0.0f);
+    for(size_t k = 0; k < max(frame, count); k++){
+        double angle = fmod(0.5 * dw * double(k) * k, 2.0 * M_PI);
+        if(k < count){
+            kernel_re[k] = cos(angle);
+            kernel_im[k] = sin(angle);
+        }
+        if(k > 0 && k < frame){
+            kernel_re[length - k] = cos(angle);
+            kernel_im[length - k] = sin(angle);
+        }
+    }
+    fft.forward(kernel_re.data(), kernel_im.data());
+
+    buffer_re.resize(length);
+    buffer_im.resize(length);
+}
+
+float ChirpZ::start() const{
+    return first;
+}
+
+float ChirpZ::stop() const{
+    return last;
+}
+
+size_t ChirpZ::bins() const{
+    return count;
+}
+
+float ChirpZ::frequency(size_t bin) const{
+    return count > 1 ? first + (last - first) * bin / (count - 1) : first;
+}
+
+float ChirpZ::magnitude(size_t bin) const{
+    return results[bin];
+}
+
+const vector<float> & ChirpZ::magnitudes() const{
+    return results;
+}
@@ -0,0 +1,108 @@
+#include "Config.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+Config::Config(const string & path){
+    try{
+        load(path);
+    }
+    catch(const invalid_argument& e){
+        throw invalid_argument("Config.constructor:\n" + string(e.what()));
+    }
+}
+
+string Config::trim(const string & text){
+    size_t begin = text.find_first_not_of(" \t\r\n");
+    if(begin == string::npos)
+        return "";
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+void Config::load(const string & path){
+    ifstream file(path);
+    if(!file)
+        throw invalid_argument("Config.load: could not open " + path);
+
+    string line;
+    size_t number = 0;
+    while(getline(file,line)){
+        number++;
+        line = trim(line.substr(0,line.find('#')));
+        if(line.empty())
+            continue;
+
+        size_t separator = line.find('=');
+        if(separator == string::npos)
+            throw invalid_argument("Config.load: expected key = value at " + path + ":" + to_string(number));
+
+        entries[trim(line.substr(0,separator))] = trim(line.substr(separator + 1));
+    }
+}
+
+bool Config::has(const string & key) const{
+    return entries.count(key);
+}
+
+string Config::get(const string & key, const string & fallback) const{
+    auto entry = entries.find(key);
+    return entry == entries.end() ? fallback : entry->second;
+}
+
+float Config::getFloat(const string & key, float fallback) const{
+    auto entry = entries.find(key);
+    if(entry == entries.end())
+        return fallback;
+    try{
+        return stof(entry->second);
+    }
+    catch(const exception&){
+        throw invalid_argument("Config.getFloat: " + key + " is not a number: " + entry->second);
+    }
+}
+
+size_t Config::getSize(const string & key, size_t fallback) const{
+    auto entry = entries.find(key);
+    if(entry == entries.end())
+        return fallback;
+    try{
+        return stoul(entry->second);
+    }
+    catch(const exception&){
+        throw invalid_argument("Config.getSize: " + key + " is not an unsigned integer: " + entry->second);
+    }
+}
+
+bool Config::getBool(const string & key, bool fallback) const{
+    auto entry = entries.find(key);
+    if(entry == entries.end())
+        return fallback;
+    const string & value = entry->second;
+    if(value == "true" || value == "yes" || value == "on" || value == "1")
+        return true;
+    if(value == "false" || value == "no" || value == "off" || value == "0")
+        return false;
+    throw invalid_argument("Config.getBool: " + key + " is not a boolean: " + value);
+}
+
+vector<float> Config::getList(const string & key) const{
+    vector<float> values;
+    stringstream stream(get(key));
+    string item;
+    while(getline(stream,item,',')){
+        item = trim(item);
+        if(item.empty())
+            continue;
+        try{
+            values.push_back(stof(item));
+        }
+        catch(const exception&){
+            throw invalid_argument("Config.getList: " + key + " has a non numeric entry: " + item);
+        }
+    }
+    return values;
+}
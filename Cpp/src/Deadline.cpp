@@ -0,0 +1,78 @@
+#include "Deadline.hpp"
+
+Deadline::Deadline(float high, float low, size_t hold) : high(high), low(low), hold(hold){}
+
+bool Deadline::frame(uint64_t elapsed){
+    float ratio = float(elapsed) / PERIOD;
+    float load = smoothed.load(std::memory_order_relaxed) * 0.9f + ratio * 0.1f;
+    smoothed.store(load, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    bool miss = elapsed > PERIOD;
+    if(miss)
+        missed.fetch_add(1, std::memory_order_relaxed);
+
+    size_t level = current.load(std::memory_order_relaxed);
+    size_t next = level;
+    since++;
+    calm = load < low ? calm + 1 : 0;
+
+    if(!policy.load(std::memory_order_relaxed))
+        next = 0;
+    else if((miss || load > high) && since >= COOLDOWN && level + 1 < QUALITY.size())
+        next = level + 1;
+    else if(calm >= hold && level > 0)
+        next = level - 1;
+
+    if(next == level)
+        return false;
+    current.store(next, std::memory_order_relaxed);
+    since = 0;
+    calm = 0;
+    return true;
+}
+
+void Deadline::setAdaptive(bool adaptive){
+    policy.store(adaptive, std::memory_order_relaxed);
+}
+
+bool Deadline::adaptive() const{
+    return policy.load(std::memory_order_relaxed);
+}
+
+size_t Deadline::level() const{
+    return current.load(std::memory_order_relaxed);
+}
+
+const Quality & Deadline::quality() const{
+    return QUALITY[level()];
+}
+
+uint64_t Deadline::frames() const{
+    return total.load(std::memory_order_relaxed);
+}
+
+uint64_t Deadline::misses() const{
+    return missed.load(std::memory_order_relaxed);
+}
+
+float Deadline::load() const{
+    return smoothed.load(std::memory_order_relaxed);
+}
+
+void Deadline::clear(){
+    total.store(0, std::memory_order_relaxed);
+    missed.store(0, std::memory_order_relaxed);
+}
+
+void Deadline::print(FILE * file, const char * prefix) const{
+    fprintf(file, "%sdeadline %.2f ms: %llu frames, %llu missed, load %.2f, quality level %zu%s\n",
+        prefix,
+        PERIOD * 1e-6,
+        (unsigned long long)frames(),
+        (unsigned long long)misses(),
+        load(),
+        level(),
+        adaptive() ? " (adaptive)" : ""
+    );
+    fflush(file);
+}
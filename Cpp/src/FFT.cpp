@@ -0,0 +1,164 @@
+#include "FFT.hpp"
+
+#include <cmath>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+FFT::FFT(size_t size){
+    resize(size);
+}
+
+void FFT::resize(size_t size){
+    if(size & (size - 1))
+        throw(invalid_argument("FFT.resize: size must be a power of two: " + to_string(size)));
+    length = size;
+
+    size_t bits = 0;
+    while((size_t(1) << bits) < size)
+        bits++;
+    reversal.resize(size);
+    for(size_t i = 0; i < size; i++){
+        uint32_t reversed = 0;
+        for(size_t bit = 0; bit < bits; bit++)
+            reversed |= ((i >> bit) & 1) << (bits - 1 - bit);
+        reversal[i] = reversed;
+    }
+
+    twiddle_re.resize(size ? size - 1 : 0);
+    twiddle_im.resize(size ? size - 1 : 0);
+    for(size_t half = 1; half < size; half <<= 1)
+        for(size_t j = 0; j < half; j++){
+            double angle = -M_PI * j / half;
+            twiddle_re[half - 1 + j] = cos(angle);
+            twiddle_im[half - 1 + j] = sin(angle);
+        }
+}
+
+size_t FFT::size() const{
+    return length;
+}
+
+void FFT::forward(float * __restrict re, float * __restrict im) const{
+    for(size_t i = 0; i < length; i++)
+        if(i < reversal[i]){
+            swap(re[i], re[reversal[i]]);
+            swap(im[i], im[reversal[i]]);
+        }
+
+    for(size_t half = 1; half < length; half <<= 1){
+        const float * w_re = twiddle_re.data() + half - 1;
+        const float * w_im = twiddle_im.data() + half - 1;
+        for(size_t block = 0; block < length; block += 2 * half){
+            float * a_re = re + block;
+            float * a_im = im + block;
+            float * b_re = a_re + half;
+            float * b_im = a_im + half;
+            for(size_t j = 0; j < half; j++){
+                float t_re = w_re[j] * b_re[j] - w_im[j] * b_im[j];
+                float t_im = w_re[j] * b_im[j] + w_im[j] * b_re[j];
+                b_re[j] = a_re[j] - t_re;
+                b_im[j] = a_im[j] - t_im;
+                a_re[j] += t_re;
+                a_im[j] += t_im;
+            }
+        }
+    }
+}
+
+//conj(FFT(conj(x))), done by swapping the parts
+void FFT::inverse(float * re, float * im) const{
+    forward(im, re);
+}
+
+RealFFT::RealFFT(size_t size){
+    resize(size);
+}
+
+void RealFFT::resize(size_t size){
+    if(size == 1 || (size & (size - 1)))
+        throw(invalid_argument("RealFFT.resize: size must be 0 or a power of two of at least 2: " + to_string(size)));
+    length = size;
+    if(!size){
+        half.resize(0);
+        buffer_re.clear();
+        buffer_im.clear();
+        spectrum_re.clear();
+        spectrum_im.clear();
+        split_re.clear();
+        split_im.clear();
+        return;
+    }
+    half.resize(size / 2);
+    buffer_re.assign(size / 2, 0.0f);
+    buffer_im.assign(size / 2, 0.0f);
+    spectrum_re.assign(size / 2 + 1, 0.0f);
+    spectrum_im.assign(size / 2 + 1, 0.0f);
+    split_re.resize(size / 2);
+    split_im.resize(size / 2);
+    for(size_t k = 0; k < size / 2; k++){
+        double angle = -2.0 * M_PI * k / size;
+        split_re[k] = cos(angle);
+        split_im[k] = sin(angle);
+    }
+}
+
+size_t RealFFT::size() const{
+    return length;
+}
+
+size_t RealFFT::bins() const{
+    return length ? length / 2 + 1 : 0;
+}
+
+void RealFFT::forward(const float * samples, size_t count){
+    size_t pairs = min(count, length) / 2;
+    for(size_t n = 0; n < pairs; n++){
+        buffer_re[n] = samples[2 * n];
+        buffer_im[n] = samples[2 * n + 1];
+    }
+    fill(buffer_re.begin() + pairs, buffer_re.end(), 0.0f);
+    fill(buffer_im.begin() + pairs, buffer_im.end(), 0.0f);
+    if(count < length && count % 2)
+        buffer_re[pairs] = samples[count - 1];
+
+    half.forward(buffer_re.data(), buffer_im.data());
+
+    //X[k] = (Z[k] + Z*[M-k]) / 2 - j e^{-2 pi j k / size} (Z[k] - Z*[M-k]) / 2, M = size / 2
+    size_t m = length / 2;
+    spectrum_re[0] = buffer_re[0] + buffer_im[0];
+    spectrum_im[0] = 0.0f;
+    spectrum_re[m] = buffer_re[0] - buffer_im[0];
+    spectrum_im[m] = 0.0f;
+    for(size_t k = 1; k < m; k++){
+        float z_re = buffer_re[k], z_im = buffer_im[k];
+        float c_re = buffer_re[m - k], c_im = -buffer_im[m - k];
+        float even_re = 0.5f * (z_re + c_re), even_im = 0.5f * (z_im + c_im);
+        float odd_re = 0.5f * (z_im - c_im), odd_im = -0.5f * (z_re - c_re);
+        spectrum_re[k] = even_re + split_re[k] * odd_re - split_im[k] * odd_im;
+        spectrum_im[k] = even_im + split_re[k] * odd_im + split_im[k] * odd_re;
+    }
+}
+
+float RealFFT::re(size_t bin) const{
+    return spectrum_re[bin];
+}
+
+float RealFFT::im(size_t bin) const{
+    return spectrum_im[bin];
+}
+
+const float * RealFFT::re() const{
+    return spectrum_re.data();
+}
+
+const float * RealFFT::im() const{
+    return spectrum_im.data();
+}
+
+float RealFFT::power(size_t bin) const{
+    return spectrum_re[bin] * spectrum_re[bin] + spectrum_im[bin] * spectrum_im[bin];
+}
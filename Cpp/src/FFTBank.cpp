@@ -0,0 +1,107 @@
+#include "FFTBank.hpp"
+
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+void FFTBank::rebuild(vector<float> && frequencies){
+    frequency_list = std::move(frequencies);
+    results.assign(frequency_list.size(), 0.0f);
+    if(fft.size())
+        place(fft.size() / OVERSAMPLING);
+}
+
+//interpolation weights of every analyzer for frames of `frame` samples
+void FFTBank::place(size_t frame){
+    if(fft.size() != OVERSAMPLING * frame)
+        fft.resize(OVERSAMPLING * frame);
+
+    //X[-k] = X*[k] and X[nyquist + k] = X*[nyquist - k] fold the samples past either
+    //end back into the TAPS stored ones next to it
+    const long nyquist = long(fft.bins()) - 1;
+    first.resize(frequency_list.size());
+    taps.assign(TAPS * frequency_list.size(), Tap{0, 0, 0, 0});
+    for(size_t i = 0; i < frequency_list.size(); i++){
+        //TAPS / 2 samples on each side
+        double position = frequency_list[i] / resolution(frame);
+        long start = long(floor(position)) - long(TAPS / 2) + 1;
+        first[i] = clamp<long>(start, 0, nyquist + 1 - long(TAPS));
+
+        for(size_t node = 0; node < TAPS; node++){
+            double weight = 1.0;
+            for(size_t other = 0; other < TAPS; other++)
+                if(other != node)
+                    weight *= (position - start - other) / (double(node) - double(other));
+            //e^{j pi f (frame - 1)}: the frame centred on t = 0
+            long k = start + long(node);
+            double phase = M_PI * double(k) * (frame - 1) / double(fft.size());
+            float w_re = weight * cos(phase);
+            float w_im = weight * sin(phase);
+
+            long bin = k < 0 ? -k : k > nyquist ? 2 * nyquist - k : k;
+            bool mirrored = bin != k;
+            Tap & tap = taps[i * TAPS + (bin - first[i])];
+            tap.re_re += w_re;
+            tap.re_im += mirrored ? w_im : -w_im;
+            tap.im_re += w_im;
+            tap.im_im += mirrored ? -w_re : w_re;
+        }
+    }
+}
+
+void FFTBank::add(const vector<float> & frequencies){
+    for(float frequency : frequencies)
+        if(frequency > SAMPLE_RATE/2)
+            throw(invalid_argument("FFTBank.add: frequency must smaller than half of the sample rate: " + to_string(SAMPLE_RATE) + " sps"));
+
+    vector<float> sorted = frequencies;
+    sort(sorted.begin(), sorted.end());
+
+    vector<float> merged;
+    merged.reserve(frequency_list.size() + sorted.size());
+    set_union(frequency_list.begin(), frequency_list.end(), sorted.begin(), sorted.end(), back_inserter(merged));
+    merged.erase(unique(merged.begin(), merged.end()), merged.end());
+    rebuild(std::move(merged));
+}
+
+void FFTBank::remove(const vector<float> & frequencies){
+    vector<float> sorted = frequencies;
+    sort(sorted.begin(), sorted.end());
+
+    vector<float> kept;
+    kept.reserve(frequency_list.size());
+    set_difference(frequency_list.begin(), frequency_list.end(), sorted.begin(), sorted.end(), back_inserter(kept));
+    if(kept.size() != frequency_list.size())
+        rebuild(std::move(kept));
+}
+
+void FFTBank::clear(){
+    rebuild({});
+}
+
+//index of the frequency, size() when it is not in the bank
+size_t FFTBank::find(float frequency) const{
+    auto position = lower_bound(frequency_list.begin(), frequency_list.end(), frequency);
+    if(position == frequency_list.end() || *position != frequency)
+        return frequency_list.size();
+    return position - frequency_list.begin();
+}
+
+size_t FFTBank::size() const{
+    return frequency_list.size();
+}
+
+const vector<float> & FFTBank::frequencies() const{
+    return frequency_list;
+}
+
+float FFTBank::magnitude(size_t index) const{
+    return results[index];
+}
+
+float FFTBank::resolution(size_t frame){
+    return float(SAMPLE_RATE) / (OVERSAMPLING * frame);
+}
@@ -0,0 +1,153 @@
+#include "FlightRecorder.hpp"
+#include "Constants.hpp"
+
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+// RIFF header for mono PCM16 (format 1) or float32 (format 3)
+struct WaveHeader{
+    char riff[4];
+    uint32_t riff_size;
+    char wave[4];
+    char fmt[4];
+    uint32_t fmt_size;
+    uint16_t format;
+    uint16_t channels;
+    uint32_t rate;
+    uint32_t byte_rate;
+    uint16_t block_align;
+    uint16_t bits;
+    char data[4];
+    uint32_t data_size;
+};
+
+static_assert(sizeof(WaveHeader) == 44);
+
+FlightRecorder::FlightRecorder(float seconds, bool compress) : capacity(seconds * SAMPLE_RATE), compress(compress){
+    if(capacity < 4 * CHUNK)
+        throw invalid_argument("FlightRecorder.constructor: at least " + to_string(4.0f * CHUNK / SAMPLE_RATE) + " s are needed");
+
+    if(compress)
+        compressed.resize(capacity);
+    else
+        samples.resize(capacity);
+
+    worker = thread(&FlightRecorder::work, this);
+}
+
+FlightRecorder::~FlightRecorder(){
+    {
+        lock_guard<mutex> guard(lock);
+        running = false;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void FlightRecorder::record(const float * frame, size_t count){
+    uint64_t position = written.load(memory_order_relaxed);
+    for(size_t i = 0; i < count; i++){
+        size_t index = (position + i) % capacity;
+        if(compress)
+            compressed[index] = lround(clamp(frame[i], -1.0f, 1.0f) * 32767.0f);
+        else
+            samples[index] = frame[i];
+    }
+    written.store(position + count, memory_order_release);
+}
+
+void FlightRecorder::dump(const string & path, float delay){
+    {
+        lock_guard<mutex> guard(lock);
+        requests.push_back({path, delay});
+    }
+    wake.notify_one();
+}
+
+size_t FlightRecorder::memory() const{
+    return compress ? capacity * sizeof(int16_t) : capacity * sizeof(float);
+}
+
+void FlightRecorder::work(){
+    unique_lock<mutex> guard(lock);
+    while(true){
+        wake.wait(guard, [this](){ return !running || !requests.empty(); });
+        if(requests.empty())
+            return;
+
+        Request request = std::move(requests.front());
+        requests.pop_front();
+        guard.unlock();
+
+        //post trigger audio
+        this_thread::sleep_for(chrono::duration<float>(request.delay));
+        write(request.path);
+
+        guard.lock();
+    }
+}
+
+void FlightRecorder::write(const string & path){
+    FILE * file = fopen(path.data(), "wb");
+    if(!file){
+        fprintf(stderr, "FlightRecorder.write: could not open %s\n", path.data());
+        return;
+    }
+
+    uint16_t bits = compress ? 16 : 32;
+    WaveHeader header = {
+        {'R','I','F','F'}, 0, {'W','A','V','E'}, {'f','m','t',' '}, 16,
+        (uint16_t)(compress ? 1 : 3), 1, SAMPLE_RATE, (uint32_t)(SAMPLE_RATE * bits / 8), (uint16_t)(bits / 8), bits,
+        {'d','a','t','a'}, 0
+    };
+    fwrite(&header, sizeof(header), 1, file);
+
+    //leave one chunk of slack between us and the writer
+    uint64_t end = written.load(memory_order_acquire);
+    uint64_t position = end > capacity - CHUNK ? end - (capacity - CHUNK) : 0;
+    uint64_t lost = 0;
+    size_t count = 0;
+
+    uint8_t chunk[CHUNK * sizeof(float)];
+    size_t size = bits / 8;
+    while(position < end){
+        size_t length = min<uint64_t>(CHUNK, end - position);
+        for(size_t i = 0; i < length; i++){
+            size_t index = (position + i) % capacity;
+            if(compress)
+                memcpy(chunk + i * size, &compressed[index], size);
+            else
+                memcpy(chunk + i * size, &samples[index], size);
+        }
+
+        //the capture thread (and the frame it may be writing) lapped this chunk, skip to what is still there;
+        //the fence keeps the copy above from being satisfied after this re-read, as in a seqlock reader
+        atomic_thread_fence(memory_order_acquire);
+        uint64_t now = written.load(memory_order_relaxed);
+        if(now + CHUNK > position + capacity){
+            uint64_t oldest = now + 2 * CHUNK - capacity;
+            lost += oldest - position;
+            position = oldest;
+            continue;
+        }
+
+        fwrite(chunk, size, length, file);
+        position += length;
+        count += length;
+    }
+
+    header.data_size = count * size;
+    header.riff_size = sizeof(WaveHeader) - 8 + header.data_size;
+    fseek(file, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, file);
+    fclose(file);
+
+    if(lost)
+        fprintf(stderr, "FlightRecorder.write: %s lost %llu samples to the capture thread\n", path.data(), (unsigned long long)lost);
+}
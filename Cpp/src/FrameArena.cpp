@@ -0,0 +1,73 @@
+#include "FrameArena.hpp"
+
+#include <new>
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
+
+using namespace std;
+
+FrameArena::FrameArena(size_t capacity) :
+    memory(new byte[capacity]),
+    length(capacity){}
+
+void * FrameArena::allocate(size_t bytes, size_t alignment){
+    size_t start = (used + alignment - 1) & ~(alignment - 1);
+    if(start + bytes <= length){
+        used = start + bytes;
+        return memory.get() + start;
+    }
+
+    //new[] of byte is only aligned to max_align_t, pad for anything stricter
+    overflow.emplace_back(new byte[bytes + alignment]);
+    overflow_bytes += bytes + alignment;
+    uintptr_t address = reinterpret_cast<uintptr_t>(overflow.back().get());
+    return reinterpret_cast<void*>((address + alignment - 1) & ~(uintptr_t(alignment) - 1));
+}
+
+void FrameArena::reset(){
+    if(!overflow.empty()){
+        length = max(2 * length, used + overflow_bytes);
+        memory.reset(new byte[length]);
+        overflow.clear();
+        overflow_bytes = 0;
+    }
+    used = 0;
+}
+
+size_t FrameArena::capacity() const{
+    return length;
+}
+
+size_t FrameArena::size() const{
+    return used + overflow_bytes;
+}
+
+#ifdef BAS_ALLOCATION_COUNTER
+//cmake -DALLOCATION_COUNTER=ON counts every global operator new on the thread
+//that makes it, the array and sized forms fall through to these by default
+static thread_local size_t heap_allocations = 0;
+
+void * operator new(size_t size){
+    heap_allocations++;
+    if(void * pointer = malloc(size ? size : 1))
+        return pointer;
+    throw bad_alloc();
+}
+
+void operator delete(void * pointer) noexcept{
+    free(pointer);
+}
+
+void operator delete(void * pointer, size_t) noexcept{
+    free(pointer);
+}
+
+size_t FrameArena::heapAllocations(){
+    return heap_allocations;
+}
+#else
+size_t FrameArena::heapAllocations(){
+    return 0;
+}
+#endif
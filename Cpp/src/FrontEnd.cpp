@@ -1,5 +1,7 @@
 #include "FrontEnd.hpp"
 #include "../include/BackEnd.hpp"
+#include "../include/Scheduler.hpp"
+#include "../include/Trace.hpp"
 
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
@@ -9,8 +11,7 @@
 #include <cmath>
 #include <cfloat> 
 #include <cstdio>
-#include <iomanip>
-#include <sstream>
+#include <iostream>
 #include <GLFW/glfw3.h>
 
 // Guarda os dados de todos os analisadores criados (1 analisador = 1 frequência monitorada)
@@ -19,6 +20,29 @@ std::map<float, FrontEnd::GoertzelAnalyzerData> FrontEnd::Application::s_analyze
 // Valor padrão de frequência que aparece no input ao iniciar o programa
 float FrontEnd::Application::s_new_frequency_input = 1000.0f;
 
+// Frequências dos analisadores em ordem crescente (refeita quando o conjunto muda)
+std::vector<float> FrontEnd::Application::s_analyzer_list;
+
+// Grade padrão: 2048 analisadores de 20 Hz a 20 kHz em escala logarítmica
+float FrontEnd::Application::s_grid_start = 20.0f;
+float FrontEnd::Application::s_grid_stop = 20000.0f;
+int FrontEnd::Application::s_grid_count = 2048;
+bool FrontEnd::Application::s_grid_logarithmic = true;
+bool FrontEnd::Application::s_grid_low_priority = false;
+
+// Banda padrão: 201 pontos entre 900 Hz e 1,1 kHz (1 Hz por ponto)
+std::vector<Band> FrontEnd::Application::s_bands;
+uint64_t FrontEnd::Application::s_band_generation = 0;
+float FrontEnd::Application::s_band_start = 900.0f;
+float FrontEnd::Application::s_band_stop = 1100.0f;
+int FrontEnd::Application::s_band_bins = 201;
+
+// Analisador harmônico desligado até ser aplicado; padrão de 10 harmônicas de 60 Hz
+Harmonics FrontEnd::Application::s_harmonics;
+float FrontEnd::Application::s_harmonic_fundamental = 60.0f;
+int FrontEnd::Application::s_harmonic_count = 10;
+bool FrontEnd::Application::s_harmonic_track = false;
+
 // Índice da fonte de áudio selecionada (ex.: microfone padrão do sistema)
 int FrontEnd::Application::s_selected_source_index = 0;
 
@@ -29,6 +53,52 @@ std::vector<std::string> FrontEnd::Application::s_audio_sources;
 double FrontEnd::Application::s_min_magnitude = 0.0;
 double FrontEnd::Application::s_max_magnitude = 1.0;
 
+// Último pico estimado pela thread de análise
+std::pair<float, float> FrontEnd::Application::s_peak = {0.0f, 0.0f};
+
+// Instantes do último resultado consumido, para medir a latência até a tela
+uint64_t FrontEnd::Application::s_last_captured = 0;
+uint64_t FrontEnd::Application::s_last_published = 0;
+int FrontEnd::Application::s_performance_metric = Telemetry::AUDIO_TO_PIXEL;
+std::string FrontEnd::Application::s_trace_path;
+int FrontEnd::Application::s_engine = SpectrumBank::AUTO;
+bool FrontEnd::Application::s_extended = false;
+
+// Espectrograma persistente e os rótulos do eixo Y (refeitos só quando os analisadores mudam)
+Spectrogram FrontEnd::Application::s_spectrogram(SPECTROGRAM_HISTORY);
+SpectrogramTexture FrontEnd::Application::s_spectrogram_texture;
+std::vector<float> FrontEnd::Application::s_spectrogram_column;
+std::vector<double> FrontEnd::Application::s_spectrogram_ticks;
+std::vector<std::string> FrontEnd::Application::s_spectrogram_labels;
+std::vector<const char*> FrontEnd::Application::s_spectrogram_label_pointers;
+
+// Arena dos temporários de cada quadro
+FrameArena FrontEnd::Application::s_frame_arena(FRAME_ARENA_SIZE);
+
+// Pirâmide do espectrograma e a última janela dela que foi desenhada
+SpectrogramPyramid FrontEnd::Application::s_spectrogram_pyramid(SPECTROGRAM_PYRAMID_COLUMNS, SPECTROGRAM_PYRAMID_LEVELS, SPECTROGRAM_PYRAMID_BUDGET);
+SpectrogramTexture FrontEnd::Application::s_pyramid_texture;
+SpectrogramPyramid::Window FrontEnd::Application::s_pyramid_window = {0, 0, 0, 0.0, 0.0};
+std::vector<float> FrontEnd::Application::s_pyramid_columns;
+bool FrontEnd::Application::s_pyramid_mean = false;
+
+
+// Mapeia a pirâmide do espectrograma em um arquivo; se falhar, continua só em memória
+void FrontEnd::Application::setSpectrogramSpill(const std::string& path) {
+    try {
+        s_spectrogram_pyramid.setPath(path);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        s_spectrogram_pyramid.setPath("");
+    }
+}
+
+// Liga a gravação da linha do tempo desde o início
+void FrontEnd::Application::setTracePath(const std::string& path) {
+    s_trace_path = path;
+    Trace::enable(!path.empty());
+}
 
 // Função para limitar o a frequência em duas cadas decimais
 float FrontEnd::Application::limitToTwoDecimals(float value) {
@@ -40,6 +110,7 @@ void FrontEnd::Application::initialize(GLFWwindow* window) {
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
     ImPlot::CreateContext();
+    Trace::thread("render");
     ImGuiIO& io = ImGui::GetIO(); (void)io;
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;    
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;   
@@ -54,6 +125,19 @@ void FrontEnd::Application::initialize(GLFWwindow* window) {
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init("#version 130");
 
+    // Textura do espectrograma com o mesmo colormap do ImPlot (se falhar, usa o PlotHeatmap)
+    if (s_spectrogram_texture.initialize() && s_pyramid_texture.initialize()) {
+        ImU32 colors[256];
+        for (int i = 0; i < 256; ++i)
+            colors[i] = ImGui::ColorConvertFloat4ToU32(ImPlot::SampleColormap(i / 255.0f, ImPlotColormap_Plasma));
+        s_spectrogram_texture.setColormap(colors, 256);
+        s_pyramid_texture.setColormap(colors, 256);
+    }
+    else {
+        s_spectrogram_texture.cleanup();
+        s_pyramid_texture.cleanup();
+    }
+
     // Busca todas as fontes de áudio disponíveis no sistema
     s_audio_sources = BackEnd::querySources();
     if (s_audio_sources.empty()) {
@@ -68,47 +152,208 @@ void FrontEnd::Application::initialize(GLFWwindow* window) {
 
 // Limpeza da interface (quando fechar o programa)
 void FrontEnd::Application::cleanup() {
+    if (!s_trace_path.empty()) {
+        Trace::enable(false);
+        if (!Trace::write(s_trace_path))
+            std::cerr << "Não foi possível gravar " << s_trace_path << std::endl;
+    }
+    s_spectrogram_texture.cleanup();
+    s_pyramid_texture.cleanup();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImPlot::DestroyContext();
     ImGui::DestroyContext();
 }
 
+// Refaz a lista, as linhas do espectrograma e os rótulos quando o conjunto de analisadores muda
+void FrontEnd::Application::rebuildSpectrogram() {
+    std::vector<float> frequencies;
+    frequencies.reserve(s_analyzers_data.size());
+    for (const auto& pair : s_analyzers_data)
+        frequencies.push_back(pair.first);
+    s_analyzer_list = frequencies;
+    s_spectrogram.setFrequencies(frequencies);
+    s_spectrogram_column.assign(frequencies.size(), 0.0f);
+    if (s_spectrogram_texture.valid())
+        s_spectrogram_texture.resize(s_spectrogram.rows(), s_spectrogram.width(), s_spectrogram.data());
+
+    // A pirâmide recomeça vazia com o novo número de linhas
+    try {
+        s_spectrogram_pyramid.setRows(frequencies.size());
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        setSpectrogramSpill("");
+    }
+    s_pyramid_window.count = 0;
+
+    // Com muitas linhas, rotula só uma a cada `step` para o eixo continuar legível
+    size_t step = (frequencies.size() + SPECTROGRAM_LABELS - 1) / SPECTROGRAM_LABELS;
+    size_t labels = step == 0 ? 0 : (frequencies.size() + step - 1) / step;
+    s_spectrogram_ticks.resize(labels);
+    s_spectrogram_labels.resize(labels);
+    s_spectrogram_label_pointers.resize(labels);
+    for (size_t k = 0; k < labels; ++k) {
+        s_spectrogram_ticks[k] = (double)(k * step) + 0.5; // Centraliza o tick na "linha" do heatmap
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.2f", frequencies[k * step]);
+        s_spectrogram_labels[k] = buffer;
+    }
+    for (size_t k = 0; k < labels; ++k)
+        s_spectrogram_label_pointers[k] = s_spectrogram_labels[k].c_str();
+}
+
+// Escreve a última magnitude de cada analisador como uma nova coluna do espectrograma
+void FrontEnd::Application::pushSpectrogramColumn() {
+    size_t k = 0;
+    for (const auto& pair : s_analyzers_data) {
+        const MinMaxHistory& history = pair.second.spectrum_history;
+        s_spectrogram_column[k++] = history.empty() ? 0.0f : history.back();
+    }
+    s_spectrogram.push(s_spectrogram_column.data());
+    s_spectrogram_pyramid.push(s_spectrogram_column.data());
+    if (s_spectrogram_texture.valid())
+        s_spectrogram_texture.push(s_spectrogram_column.data());
+}
+
+// Consome os resultados publicados pela thread de análise desde o último quadro
+void FrontEnd::Application::consumeAnalyses() {
+    Scheduler::drain([](const Analysis& analysis) {
+        // As duas listas estão em ordem crescente de frequência
+        size_t j = 0;
+        for (auto& pair : s_analyzers_data) {
+            GoertzelAnalyzerData& data = pair.second;
+            while (j < analysis.frequencies.size() && analysis.frequencies[j] < pair.first)
+                ++j;
+            if (data.running && j < analysis.frequencies.size() && analysis.frequencies[j] == pair.first)
+                data.spectrum_history.push(analysis.magnitudes[j]);
+        }
+        // Resultados de um conjunto de bandas diferente do atual (quadros anteriores a uma
+        // criação/remoção) são ignorados, mesmo que o número de bandas coincida
+        if (analysis.band_generation == s_band_generation && analysis.bands.size() == s_bands.size())
+            for (size_t i = 0; i < s_bands.size(); ++i)
+                s_bands[i].magnitudes.assign(analysis.bands[i].magnitudes.begin(), analysis.bands[i].magnitudes.end());
+        s_harmonics.fundamental = analysis.harmonics.fundamental;
+        s_harmonics.thd = analysis.harmonics.thd;
+        s_harmonics.magnitudes.assign(analysis.harmonics.magnitudes.begin(), analysis.harmonics.magnitudes.end());
+        s_peak = analysis.peak;
+        s_last_captured = analysis.captured;
+        s_last_published = analysis.published;
+
+        if (!s_analyzers_data.empty())
+            pushSpectrogramColumn();
+    });
+}
+
 // Gerenciamento de analisadores (criar, remover, iniciar e parar)
 
+// Capacidade do histórico de cada analisador para que o total caiba em HISTORY_BUDGET
+size_t FrontEnd::Application::historyCapacity(size_t analyzers) {
+    size_t capacity = HISTORY_CAPACITY;
+    while (capacity > HISTORY_MINIMUM && capacity * analyzers > HISTORY_BUDGET)
+        capacity >>= 1;
+    return capacity;
+}
+
 // Cria um novo analisador para uma frequência específica
 void FrontEnd::Application::addAnalyzer(float frequency) {
-    float freq_to_add = limitToTwoDecimals(frequency);
-    if (s_analyzers_data.find(freq_to_add) == s_analyzers_data.end()) {
-        BackEnd::createAnalyzer(freq_to_add);
-        GoertzelAnalyzerData new_data;
-        new_data.frequency = freq_to_add;
-        s_analyzers_data[freq_to_add] = new_data;
-    }
+    addAnalyzers({frequency});
 }
 
 // Remove um analisador existente
 void FrontEnd::Application::removeAnalyzer(float frequency) {
-    float freq_to_remove = limitToTwoDecimals(frequency);
-    if (s_analyzers_data.find(freq_to_remove) != s_analyzers_data.end()) {
-        BackEnd::destroyAnalyzer(freq_to_remove);
-        s_analyzers_data.erase(freq_to_remove);
+    removeAnalyzers({frequency});
+}
+
+// Cria vários analisadores de uma vez; o backend realoca o banco uma única vez
+void FrontEnd::Application::addAnalyzers(const std::vector<float>& frequencies, bool low_priority) {
+    std::vector<float> added;
+    added.reserve(frequencies.size());
+    for (float frequency : frequencies) {
+        float freq_to_add = limitToTwoDecimals(frequency);
+        if (s_analyzers_data.find(freq_to_add) == s_analyzers_data.end())
+            added.push_back(freq_to_add);
+    }
+    std::sort(added.begin(), added.end());
+    added.erase(std::unique(added.begin(), added.end()), added.end());
+    if (added.empty())
+        return;
+
+    Scheduler::addFrequencies(added, low_priority);
+    size_t capacity = historyCapacity(s_analyzers_data.size() + added.size());
+    for (float frequency : added)
+        s_analyzers_data.try_emplace(frequency, frequency, capacity).first->second.low_priority = low_priority;
+    rebuildSpectrogram();
+}
+
+// Move um analisador entre o banco principal e o de baixa prioridade
+void FrontEnd::Application::setPriority(float frequency, bool low_priority) {
+    auto analyzer = s_analyzers_data.find(limitToTwoDecimals(frequency));
+    if (analyzer == s_analyzers_data.end() || analyzer->second.low_priority == low_priority)
+        return;
+    Scheduler::addFrequencies({analyzer->first}, low_priority);
+    analyzer->second.low_priority = low_priority;
+}
+
+// Remove vários analisadores de uma vez
+void FrontEnd::Application::removeAnalyzers(const std::vector<float>& frequencies) {
+    std::vector<float> removed;
+    removed.reserve(frequencies.size());
+    for (float frequency : frequencies) {
+        float freq_to_remove = limitToTwoDecimals(frequency);
+        if (s_analyzers_data.erase(freq_to_remove))
+            removed.push_back(freq_to_remove);
+    }
+    if (removed.empty())
+        return;
+
+    Scheduler::removeFrequencies(removed);
+    rebuildSpectrogram();
+}
+
+// Cria um analisador de banda; o backend recusa bandas inválidas
+void FrontEnd::Application::addBand(float start, float stop, int bins) {
+    try {
+        s_band_generation = Scheduler::addBand(start, stop, bins);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return;
+    }
+    s_bands.push_back(Band{start, bins > 1 ? stop : start, std::vector<float>(bins, 0.0f)});
+}
+
+// Remove o analisador de banda na posição `index` da lista
+void FrontEnd::Application::removeBand(size_t index) {
+    if (index >= s_bands.size())
+        return;
+    s_band_generation = Scheduler::removeBand(index);
+    s_bands.erase(s_bands.begin() + index);
+}
+
+// Liga, reconfigura ou (com count = 0) desliga o analisador harmônico
+void FrontEnd::Application::setHarmonics(float fundamental, int count, bool track) {
+    try {
+        Scheduler::setHarmonics(fundamental, count, track);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
     }
 }
 
 // Inicia um analisador (liga o processamento do backend)
 void FrontEnd::Application::startAnalyzer(float frequency) {
-    float freq_to_start = limitToTwoDecimals(frequency);
-    if (s_analyzers_data.count(freq_to_start)) {
-        s_analyzers_data[freq_to_start].running = true;
+    auto analyzer = s_analyzers_data.find(limitToTwoDecimals(frequency));
+    if (analyzer != s_analyzers_data.end()) {
+        analyzer->second.running = true;
     }
 }
 
 // Para um analisador (pausa o processamento do backend)
 void FrontEnd::Application::stopAnalyzer(float frequency) {
-    float freq_to_stop = limitToTwoDecimals(frequency);
-    if (s_analyzers_data.count(freq_to_stop)) {
-        s_analyzers_data[freq_to_stop].running = false;
+    auto analyzer = s_analyzers_data.find(limitToTwoDecimals(frequency));
+    if (analyzer != s_analyzers_data.end()) {
+        analyzer->second.running = false;
     }
 }
 
@@ -123,6 +368,7 @@ std::vector<std::string> FrontEnd::Application::getAvailableAudioSources() {
 
 // Página de configuração de analisadores
 void FrontEnd::Application::showConfigurationPage() {
+    TRACE_SCOPE("FrontEnd::showConfigurationPage");
     ImGui::Text("Seleção de Fonte de Áudio");
     ImGui::Separator();
     ImGui::Spacing();
@@ -175,16 +421,52 @@ void FrontEnd::Application::showConfigurationPage() {
     ImGui::Separator();
     ImGui::Spacing();
 
-    // Lista de analisadores já criados
-    ImGui::Text("Analisadores Ativos");
+    // Grade de analisadores (linear ou logarítmica) criada de uma vez
+    ImGui::Text("Criar Grade de Analisadores");
+    ImGui::InputFloat("Início (Hz)", &s_grid_start, 1.0f, 100.0f, "%.2f Hz");
+    ImGui::InputFloat("Fim (Hz)", &s_grid_stop, 1.0f, 100.0f, "%.2f Hz");
+    ImGui::InputInt("Quantidade", &s_grid_count, 1, 256);
+    ImGui::Checkbox("Espaçamento logarítmico", &s_grid_logarithmic);
+    ImGui::Checkbox("Baixa prioridade (menos análises por segundo sob carga)", &s_grid_low_priority);
+    s_grid_start = std::clamp(s_grid_start, 0.01f, SAMPLE_RATE / 2.0f);
+    s_grid_stop = std::clamp(s_grid_stop, s_grid_start, SAMPLE_RATE / 2.0f);
+    s_grid_count = std::clamp(s_grid_count, 1, 16384);
+
+    if (ImGui::Button("Criar grade")) {
+        std::vector<float> grid(s_grid_count);
+        for (int i = 0; i < s_grid_count; ++i) {
+            float position = s_grid_count == 1 ? 0.0f : (float)i / (float)(s_grid_count - 1);
+            grid[i] = s_grid_logarithmic
+                ? s_grid_start * std::pow(s_grid_stop / s_grid_start, position)
+                : s_grid_start + (s_grid_stop - s_grid_start) * position;
+        }
+        addAnalyzers(grid, s_grid_low_priority);
+        for (float frequency : grid)
+            startAnalyzer(frequency);
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Remover todos")) {
+        std::vector<float> all = s_analyzer_list;
+        removeAnalyzers(all);
+    }
+
+    ImGui::Separator();
+    ImGui::Spacing();
+
+    // Lista de analisadores já criados; o clipper só desenha as linhas visíveis
+    ImGui::Text("Analisadores Ativos (%zu)", s_analyzer_list.size());
     if (s_analyzers_data.empty()) {
         ImGui::Text("Nenhum analisador ativo.");
     } else {
-        for (auto it = s_analyzers_data.begin(); it != s_analyzers_data.end(); ) {
-            float freq = it->first;
-            GoertzelAnalyzerData& data = it->second;
-
-            ImGui::PushID(freq);
+        float freq_to_remove = -1.0f;
+        ImGui::BeginChild("##AnalyzerList", ImVec2(0, 300), true);
+        ImGuiListClipper clipper;
+        clipper.Begin((int)s_analyzer_list.size());
+        while (clipper.Step()) for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+            float freq = s_analyzer_list[row];
+            GoertzelAnalyzerData& data = s_analyzers_data.find(freq)->second;
+
+            ImGui::PushID(row); // frequências abaixo de 1 Hz de distância colidiriam como ID inteiro
             ImGui::Text("Frequência: %.2f Hz", freq);
             ImGui::SameLine();
             
@@ -198,71 +480,127 @@ void FrontEnd::Application::showConfigurationPage() {
             }
             ImGui::SameLine();
 
-            // Botão remover
+            bool low_priority = data.low_priority;
+            if (ImGui::Checkbox("Baixa prioridade", &low_priority))
+                setPriority(freq, low_priority);
+            ImGui::SameLine();
+
+            // Botão remover (aplicado depois da lista, que ainda está sendo percorrida)
             if (ImGui::Button("Remover")) {
-                removeAnalyzer(freq);
-                ImGui::PopID();
-                break; // sai do loop porque o iterador ficou inválido
+                freq_to_remove = freq;
             }
 
             ImGui::PopID();
-            ++it;
         }
+        ImGui::EndChild();
+
+        if (freq_to_remove >= 0.0f)
+            removeAnalyzer(freq_to_remove);
+    }
+
+    ImGui::Spacing();
+    ImGui::Separator();
+    ImGui::Spacing();
+
+    // Analisadores de banda: muitos pontos em um trecho estreito do espectro por uma transformada chirp-Z
+    ImGui::Text("Analisadores de Banda (chirp-Z)");
+    ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f),
+        "Pontos igualmente espaçados entre o início e o fim, calculados juntos a cada quadro");
+    ImGui::InputFloat("Início (Hz)##Banda", &s_band_start, 1.0f, 100.0f, "%.2f Hz");
+    ImGui::InputFloat("Fim (Hz)##Banda", &s_band_stop, 1.0f, 100.0f, "%.2f Hz");
+    ImGui::InputInt("Pontos##Banda", &s_band_bins, 1, 64);
+    s_band_start = std::clamp(s_band_start, 0.0f, SAMPLE_RATE / 2.0f);
+    s_band_stop = std::clamp(s_band_stop, s_band_start, SAMPLE_RATE / 2.0f);
+    s_band_bins = std::clamp(s_band_bins, 1, 65536);
+
+    if (ImGui::Button("Adicionar banda"))
+        addBand(s_band_start, s_band_stop, s_band_bins);
+
+    if (s_bands.empty()) {
+        ImGui::Text("Nenhuma banda ativa.");
+    } else {
+        int band_to_remove = -1;
+        for (size_t i = 0; i < s_bands.size(); ++i) {
+            ImGui::PushID((int)i);
+            ImGui::Text("Banda %zu: %.2f Hz a %.2f Hz, %zu pontos", i + 1, s_bands[i].start, s_bands[i].stop, s_bands[i].magnitudes.size());
+            ImGui::SameLine();
+            if (ImGui::Button("Remover"))
+                band_to_remove = (int)i;
+            ImGui::PopID();
+        }
+        if (band_to_remove >= 0)
+            removeBand(band_to_remove);
     }
 
+    ImGui::Spacing();
+    ImGui::Separator();
+    ImGui::Spacing();
+
+    // Analisador harmônico: uma fundamental e suas harmônicas em uma única passada
+    ImGui::Text("Analisador Harmônico");
+    ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f),
+        "Magnitude de cada harmônica (a 1ª é a fundamental) e a distorção harmônica total");
+    ImGui::InputFloat("Fundamental (Hz)", &s_harmonic_fundamental, 1.0f, 10.0f, "%.2f Hz");
+    ImGui::InputInt("Harmônicas", &s_harmonic_count, 1, 4);
+    ImGui::Checkbox("Seguir o pico a cada quadro", &s_harmonic_track);
+    s_harmonic_fundamental = std::clamp(s_harmonic_fundamental, 0.01f, SAMPLE_RATE / 2.0f);
+    s_harmonic_count = std::clamp(s_harmonic_count, 1, (int)HarmonicAnalyzer::MAX_HARMONICS);
+
+    if (ImGui::Button("Aplicar harmônicas"))
+        setHarmonics(s_harmonic_fundamental, s_harmonic_count, s_harmonic_track);
+    ImGui::SameLine();
+    if (ImGui::Button("Desligar harmônicas"))
+        setHarmonics(s_harmonic_fundamental, 0, false);
+
     ImGui::Spacing();
     ImGui::Separator();
 }
 
 // Página de visualização individual por analisador
 void FrontEnd::Application::showVisualizationPage() {
+    TRACE_SCOPE("FrontEnd::showVisualizationPage");
     ImGui::Text("Visualização por Analisador");
     ImGui::Separator();
     ImGui::Spacing();
 
-    double current_time = glfwGetTime();
-
     if (s_analyzers_data.empty()) {
         ImGui::Text("Adicione analisadores na página de Configuração para visualizar dados.");
         return;
     }
 
-    BackEnd::update();
-
     for (auto& pair : s_analyzers_data) {
         float freq = pair.first;
         GoertzelAnalyzerData& data = pair.second;
 
-        ImGui::PushID(freq);
+        ImGui::PushID(&data);
         ImGui::Text("Analisador: %.2f Hz", freq);
         ImGui::Text("Status: %s", data.running ? "Rodando" : "Pausado/Parado");
 
-        if (data.running && (current_time - data.last_update_time > 0)) {
-            float magnitude = BackEnd::queryFrequency(freq);
-            if (data.spectrum_history.size() > 200)
-                data.spectrum_history.erase(data.spectrum_history.begin());
-            data.spectrum_history.push_back(magnitude);
-            data.last_update_time = current_time;
-        }
-
         // Gráfico 1: magnitude no tempo
 
-        // Formata a magnitude para ficar com duas casas decimais
-        char buffer[50];
-        std::snprintf(buffer, sizeof(buffer), "Magnitude ao Longo do Tempo (%.2f Hz)", freq);
-        std::string header_mag_title(buffer);
+        // Formata a magnitude para ficar com duas casas decimais (rótulos na pilha, sem alocar)
+        char header_mag_title[64];
+        std::snprintf(header_mag_title, sizeof(header_mag_title), "Magnitude ao Longo do Tempo (%.2f Hz)", freq);
+        char plot_id[48];
+        std::snprintf(plot_id, sizeof(plot_id), "##SpectrumMagnitude%f", freq);
 
         // Permite que a seção seja expandida ou recolhida
-        if (ImGui::CollapsingHeader(header_mag_title.c_str(), ImGuiTreeNodeFlags_DefaultOpen)) {
+        if (ImGui::CollapsingHeader(header_mag_title, ImGuiTreeNodeFlags_DefaultOpen)) {
+
+            // Fora da área visível só reserva o espaço (com milhares de analisadores)
+            ImVec2 plot_size(ImGui::GetContentRegionAvail().x, 300);
+            if (!ImGui::IsRectVisible(plot_size))
+                ImGui::Dummy(plot_size);
 
             // Cria o gráfico com altura fixa (300px) e largura ajustável
-            if (ImPlot::BeginPlot((std::string("##SpectrumMagnitude") + std::to_string(freq)).c_str(), ImVec2(-1, 300))) {
+            else if (ImPlot::BeginPlot(plot_id, ImVec2(-1, 300))) {
 
                 // Define rótulos dos eixos
                 ImPlot::SetupAxes("Tempo (amostras atrás)", "Magnitude");
 
-                // Mostra o eixo X indo de valores negativos até 0 (histórico de amostras)
-                ImPlot::SetupAxisLimits(ImAxis_X1, -(float)data.spectrum_history.size(), 0, ImGuiCond_Always);
+                // Eixo X de valores negativos até 0 (histórico de amostras); só é fixado na
+                // primeira vez para o usuário poder aproximar e navegar pelo histórico
+                ImPlot::SetupAxisLimits(ImAxis_X1, -(double)data.spectrum_history.capacity(), 0, ImGuiCond_Once);
 
                 // Eixo Y: ajusta dinamicamente de 0 até 10% acima do valor máximo do histórico
                 // float y_max = 1.0f; // valor padrão caso não haja histórico
@@ -274,15 +612,17 @@ void FrontEnd::Application::showVisualizationPage() {
                 // Só plota se houver dados
                 if (!data.spectrum_history.empty()) {
 
-                    // Cria os valores do eixo X (tempo negativo → mais antigo)
-                    std::vector<float> x_indices(data.spectrum_history.size());
-                    for (size_t i = 0; i < data.spectrum_history.size(); ++i)
-                        x_indices[i] = -(float)(data.spectrum_history.size() - 1 - i);
+                    // Escolhe o nível de resolução pela largura em pixels do trecho visível,
+                    // assim o número de pontos desenhados não depende do tamanho do histórico
+                    const MinMaxHistory& history = data.spectrum_history;
+                    ImPlotRect limits = ImPlot::GetPlotLimits();
+                    size_t level = history.level(limits.X.Size(), ImPlot::GetPlotSize().x);
+                    MinMaxHistory::Window window = history.window(level, limits.X.Min, limits.X.Max);
 
-                    // Desenha a curva de magnitude ao longo do tempo
+                    // Desenha a curva de magnitude ao longo do tempo (envelope mín/máx nos níveis grossos)
                     ImPlot::PushStyleColor(ImPlotCol_Line, IM_COL32(255, 100, 100, 255));
                     ImPlot::PushStyleVar(ImPlotStyleVar_LineWeight, 2.0f);
-                    ImPlot::PlotLine("Magnitude", x_indices.data(), data.spectrum_history.data(), data.spectrum_history.size());
+                    ImPlot::PlotLine("Magnitude", window.data, (int)window.count, window.xscale, window.xstart);
                     ImPlot::PopStyleVar();
                     ImPlot::PopStyleColor();
                 }
@@ -300,16 +640,6 @@ void FrontEnd::Application::showVisualizationPage() {
     }
 }
 
-// Função auxiliar para converter std::vector<std::string> para const char* const*
-// Necessário para ImPlot::SetupAxisTicks
-static std::vector<const char*> convert_to_c_str_array(const std::vector<std::string>& vec) {
-    std::vector<const char*> c_str_vec;
-    for (const auto& s : vec) {
-        c_str_vec.push_back(s.c_str());
-    }
-    return c_str_vec;
-}
-
 // Implementação do ImGui::SliderDouble, pois não é padrão
 // Necessário para replicar o comportamento do código de referência
 namespace ImGui {
@@ -320,18 +650,51 @@ namespace ImGui {
 
 // Página de visualização geral
 void FrontEnd::Application::showOverallVisualizationPage() {
+    TRACE_SCOPE("FrontEnd::showOverallVisualizationPage");
     ImGui::Text("Visualização Geral de Frequências");
     ImGui::Separator();
     ImGui::Spacing();
 
-    double current_time = glfwGetTime();
-
-    if (s_analyzers_data.empty()) {
+    if (s_analyzers_data.empty() && s_bands.empty() && s_harmonics.magnitudes.empty()) {
         ImGui::Text("Adicione analisadores na página de Configuração para visualizar dados.");
         return;
     }
 
-    BackEnd::update();
+    // Bandas chirp-Z: uma linha por banda, no eixo de frequência
+    if (!s_bands.empty() && ImGui::CollapsingHeader("Bandas (chirp-Z)", ImGuiTreeNodeFlags_DefaultOpen)) {
+        if (ImPlot::BeginPlot("##Bands", ImVec2(-1, 300))) {
+            ImPlot::SetupAxes("Frequência (Hz)", "Magnitude");
+            for (size_t i = 0; i < s_bands.size(); ++i) {
+                const Band& band = s_bands[i];
+                size_t bins = band.magnitudes.size();
+                double step = bins > 1 ? (band.stop - band.start) / (double)(bins - 1) : 1.0;
+                char label[32];
+                snprintf(label, sizeof(label), "Banda %zu", i + 1);
+                ImPlot::PlotLine(label, band.magnitudes.data(), (int)bins, step, band.start);
+            }
+            ImPlot::EndPlot();
+        }
+        ImGui::Spacing();
+        ImGui::Separator();
+        ImGui::Spacing();
+    }
+
+    // Harmônicas: hastes nos múltiplos da fundamental
+    if (!s_harmonics.magnitudes.empty() && ImGui::CollapsingHeader("Harmônicas", ImGuiTreeNodeFlags_DefaultOpen)) {
+        ImGui::Text("Fundamental %.2f Hz, THD %.2f%%", s_harmonics.fundamental, s_harmonics.thd * 100.0f);
+        if (ImPlot::BeginPlot("##Harmonics", ImVec2(-1, 300))) {
+            ImPlot::SetupAxes("Frequência (Hz)", "Magnitude");
+            FrameVector<float> frequencies{FrameAllocator<float>(s_frame_arena)};
+            frequencies.resize(s_harmonics.magnitudes.size());
+            for (size_t k = 0; k < frequencies.size(); ++k)
+                frequencies[k] = s_harmonics.fundamental * (float)(k + 1);
+            ImPlot::PlotStems("Harmônicas", frequencies.data(), s_harmonics.magnitudes.data(), (int)frequencies.size());
+            ImPlot::EndPlot();
+        }
+        ImGui::Spacing();
+        ImGui::Separator();
+        ImGui::Spacing();
+    }
     
     // 1. Gráfico de Barras — mostra o espectro de frequência em tempo real
     if (ImGui::CollapsingHeader("Espectro de Frequência", ImGuiTreeNodeFlags_DefaultOpen)) {
@@ -341,43 +704,20 @@ void FrontEnd::Application::showOverallVisualizationPage() {
             ImPlot::SetupAxes("Frequência (Hz)", "Magnitude");
             // ImPlot::SetupAxisLimits(ImAxis_Y1, 0, 1.5);
 
-            std::vector<float> frequencies;
-            std::vector<float> magnitudes;
+            // Temporários do quadro ficam na arena
+            FrameVector<float> sorted_frequencies{FrameAllocator<float>(s_frame_arena)};
+            FrameVector<float> sorted_magnitudes{FrameAllocator<float>(s_frame_arena)};
+            sorted_frequencies.reserve(s_analyzers_data.size());
+            sorted_magnitudes.reserve(s_analyzers_data.size());
 
-            // Atualiza dados de cada analisador ativo
+            // Última magnitude de cada analisador (o std::map já percorre em ordem crescente de frequência)
             for (auto& pair : s_analyzers_data) {
                 float freq = pair.first;
                 GoertzelAnalyzerData& data = pair.second;
 
-                // Atualiza magnitude se o analisador estiver rodando e o tempo mínimo tiver passado
-                if (data.running && (current_time - data.last_update_time > 0.05)) {
-                    float magnitude = BackEnd::queryFrequency(freq);
-
-                    // Mantém histórico limitado a 200 amostras
-                    if (data.spectrum_history.size() > 200)
-                        data.spectrum_history.erase(data.spectrum_history.begin());
-
-                    data.spectrum_history.push_back(magnitude);
-                    data.last_update_time = current_time;
-                }
-
                 // Armazena frequência e última magnitude para plotar
-                frequencies.push_back(freq);
-                magnitudes.push_back(data.spectrum_history.empty() ? 0.0f : data.spectrum_history.back());
-            }
-
-            // Ordena as frequências (garante que o gráfico fique da esquerda p/ direita)
-            std::vector<std::pair<float, float>> sorted_data;
-            for (size_t i = 0; i < frequencies.size(); ++i)
-                sorted_data.push_back({frequencies[i], magnitudes[i]});
-            std::sort(sorted_data.begin(), sorted_data.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
-
-            // Separa vetores ordenados de frequência e magnitude
-            std::vector<float> sorted_frequencies;
-            std::vector<float> sorted_magnitudes;
-            for (const auto& p : sorted_data) {
-                sorted_frequencies.push_back(p.first);
-                sorted_magnitudes.push_back(p.second);
+                sorted_frequencies.push_back(freq);
+                sorted_magnitudes.push_back(data.spectrum_history.empty() ? 0.0f : data.spectrum_history.back());
             }
 
             // Só plota se houver dados válidos
@@ -408,8 +748,8 @@ void FrontEnd::Application::showOverallVisualizationPage() {
                 ImPlot::PopStyleVar();
                 ImPlot::PopStyleColor();
 
-                // Adiciona o pico do espectro
-                auto [frequency, magnitude] = BackEnd::maximum();
+                // Adiciona o pico do espectro (estimado pela thread de análise)
+                auto [frequency, magnitude] = s_peak;
 
                 ImPlot::PushStyleColor(ImPlotCol_Line, IM_COL32(255, 255, 0, 255));  // yellow stem
                 ImPlot::PushStyleVar(ImPlotStyleVar_LineWeight, 3.0f);
@@ -430,119 +770,110 @@ void FrontEnd::Application::showOverallVisualizationPage() {
     // O espectrograma mostrará o histórico de magnitude (eixo Z/cor) ao longo do tempo (eixo X) para cada frequência (eixo Y).
     if (ImGui::CollapsingHeader("Espectrograma (Histórico de Frequências)", ImGuiTreeNodeFlags_DefaultOpen)) {
         
-        int N_freqs = s_analyzers_data.size();
-        int N_history = 200; // Tamanho fixo do histórico
-        
-        // Vetor para armazenar todos os dados do espectrograma (N_freqs * N_history)
-        // Usamos float para a magnitude
-        std::vector<float> heatmap_data(N_freqs * N_history);
-        
-        // Vetor para guardar as frequências em ordem para o eixo Y
-        std::vector<float> freqs_y;
-
-        // Preenche o vetor e o vetor de frequências
-        int i = 0;
-        for (auto& pair : s_analyzers_data) {
-            float freq = pair.first;
-            GoertzelAnalyzerData& data = pair.second;
-
-            freqs_y.push_back(freq);
-
-            // Copia o histórico de magnitudes para o vetor
-            for (int j = 0; j < N_history; ++j) {
-                // Calcula o índice no histórico para mapear o tempo corretamente:
-                // O índice 'j' (0 a 199) representa o tempo. O dado mais antigo (0) vai para o índice de tempo mais baixo (0).
-                int hist_idx = j - (N_history - data.spectrum_history.size());
-                
-                float magnitude = 0.0f;
-                if (hist_idx >= 0 && hist_idx < data.spectrum_history.size()) {
-                    magnitude = data.spectrum_history[hist_idx];
-                }
-                
-                // Usa magnitude linear
-                float magnitude_linear = magnitude;
-                
-                // O índice no vetor é calculado como: (índice da frequência * N_history) + índice do tempo
-                heatmap_data[i * N_history + j] = magnitude_linear;
-            }
-            i++;
-        }
-        
-        // Cria um vetor de pares (frequência, índice original)
-        std::vector<std::pair<float, int>> freq_indices;
-        for (int k = 0; k < N_freqs; ++k) {
-            freq_indices.push_back({freqs_y[k], k});
-        }
-        
-        // Ordena pelo valor da frequência
-        std::sort(freq_indices.begin(), freq_indices.end(), [](const auto& a, const auto& b) {
-            return a.first < b.first;
-        });
-        
-        // Reorganiza o heatmap_data e freqs_y
-        std::vector<float> sorted_heatmap_data(N_freqs * N_history);
-        std::vector<float> sorted_freqs_y;
-        
-        for (int k = 0; k < N_freqs; ++k) {
-            int original_index = freq_indices[k].second;
-            float freq = freq_indices[k].first;
-            
-            // Copia a linha de dados (histórico) do índice original para a nova posição (k)
-            std::copy(
-                heatmap_data.begin() + original_index * N_history,
-                heatmap_data.begin() + (original_index + 1) * N_history,
-                sorted_heatmap_data.begin() + k * N_history
-            );
-            
-            sorted_freqs_y.push_back(freq);
-        }
+        int N_freqs = s_spectrogram.rows();
+        int N_history = s_spectrogram.width();
 
         // Plotagem do espectrograma.
         // O PlotHeatmap usa índices no eixo Y para mostrar as frequências reais. 
-        // O eixo X representa o tempo (0–200) e o Y mostra as frequências em ordem.
+        // O eixo X representa o tempo em quadros atrás (-200–0) e o Y mostra as frequências em ordem.
+        // Com zoom além das últimas colunas, a imagem vem da pirâmide no nível adequado à largura do gráfico.
+        if (ImGui::Checkbox("Média ao reduzir (em vez do máximo)", &s_pyramid_mean))
+            s_pyramid_window.count = 0;
         const float plot_height = 400.0f;
         const float scale_width = 100.0f;
         const float w = ImGui::GetContentRegionAvail().x - scale_width - ImGui::GetStyle().ItemSpacing.x;
         
         if (ImPlot::BeginPlot("##Spectrogram", ImVec2(w, plot_height), ImPlotFlags_NoMouseText)) {
             
-            ImPlot::SetupAxes("Tempo (Amostras)", "Frequência (Hz)");
+            ImPlot::SetupAxes("Tempo (quadros atrás)", "Frequência (Hz)");
             
-            // Eixo X (Tempo): 0 (mais antigo) a 200 (mais recente)
-            ImPlot::SetupAxisLimits(ImAxis_X1, 0, (double)N_history, ImGuiCond_Always); // TODO
-            //ImPlot::SetupAxisLimits(ImAxis_X1, (double)N_history, 0, ImGuiCond_Always);
+            // Eixo X (Tempo): -200 (mais antigo) a 0 (mais recente), só na primeira vez para permitir zoom
+            ImPlot::SetupAxisLimits(ImAxis_X1, -(double)N_history, 0, ImGuiCond_Once);
 
             
             // Eixo Y (Frequência): 0 a N_freqs
             ImPlot::SetupAxisLimits(ImAxis_Y1, 0, (double)N_freqs, ImGuiCond_Always);
             
             // Define os ticks do eixo Y para mostrar as frequências reais
-            std::vector<double> y_ticks_pos(N_freqs);
-            std::vector<std::string> y_ticks_labels_str(N_freqs);
-            
-            for (int k = 0; k < N_freqs; ++k) {
-                y_ticks_pos[k] = (double)k + 0.5; // Centraliza o tick na "linha" do heatmap
-                std::stringstream ss;
-                ss << std::fixed << std::setprecision(2) << sorted_freqs_y[k];
-                y_ticks_labels_str[k] = ss.str();
+            ImPlot::SetupAxisTicks(ImAxis_Y1, s_spectrogram_ticks.data(), (int)s_spectrogram_ticks.size(), s_spectrogram_label_pointers.data());
+
+            // Trecho visível: dentro das últimas colunas usa o espectrograma ao vivo, senão a pirâmide
+            ImPlotRect limits = ImPlot::GetPlotLimits();
+            const float* columns = s_spectrogram.data();
+            int N_columns = N_history;
+            double x_min = -(double)N_history, x_max = 0.0;
+            SpectrogramTexture* texture = &s_spectrogram_texture;
+
+            if (limits.X.Min < -(double)N_history && N_freqs > 0) {
+                SpectrogramPyramid::Window window = s_spectrogram_pyramid.locate(limits.X.Min, limits.X.Max, ImPlot::GetPlotSize().x);
+
+                if (s_pyramid_texture.valid()) {
+                    // A textura é um anel com as colunas do nível que terminam no fim da janela:
+                    // com o zoom parado, a janela só avança e sobem apenas as colunas novas
+                    uint64_t end = window.first + window.count;
+                    uint64_t shown_end = s_pyramid_window.first + s_pyramid_window.count;
+                    bool slide = window.count > 0 && s_pyramid_window.count > 0 && window.level == s_pyramid_window.level
+                        && window.count <= s_pyramid_window.count && end >= shown_end && end - shown_end < s_pyramid_window.count;
+
+                    if (slide) {
+                        s_pyramid_columns.resize(N_freqs);
+                        for (uint64_t index = shown_end; index < end; ++index) {
+                            s_spectrogram_pyramid.copy({window.level, index, 1, 0.0, 0.0}, s_pyramid_mean, s_pyramid_columns.data());
+                            s_pyramid_texture.push(s_pyramid_columns.data());
+                        }
+                        s_pyramid_window.first += end - shown_end;
+                    }
+                    // Zoom, deslocamento ou nível novo: reenvia tudo, com algumas colunas de folga à
+                    // esquerda (ainda guardadas no nível) para a largura poder oscilar sem outro envio
+                    else if (window.count > 0) {
+                        uint64_t complete = s_spectrogram_pyramid.frames() >> window.level;
+                        uint64_t oldest = complete > s_spectrogram_pyramid.width() ? complete - s_spectrogram_pyramid.width() : 0;
+                        uint64_t first = std::max(oldest, window.first > SPECTROGRAM_PYRAMID_SLACK ? window.first - SPECTROGRAM_PYRAMID_SLACK : 0);
+                        s_pyramid_window = {window.level, first, size_t(end - first), 0.0, 0.0};
+                        s_pyramid_columns.resize(s_pyramid_window.count * N_freqs);
+                        s_spectrogram_pyramid.copy(s_pyramid_window, s_pyramid_mean, s_pyramid_columns.data());
+                        s_pyramid_texture.resize(N_freqs, s_pyramid_window.count, s_pyramid_columns.data());
+                    }
+
+                    N_columns = window.count > 0 ? (int)s_pyramid_window.count : 0;
+                    x_max = window.xmax;
+                    x_min = window.xmax - (double)(s_pyramid_window.count << window.level);
+                }
+                // Sem textura: só copia quando a janela muda (a cada 2^nível quadros, no máximo)
+                else {
+                    if (window.level != s_pyramid_window.level || window.first != s_pyramid_window.first || window.count != s_pyramid_window.count) {
+                        s_pyramid_columns.resize(window.count * N_freqs);
+                        s_spectrogram_pyramid.copy(window, s_pyramid_mean, s_pyramid_columns.data());
+                    }
+                    s_pyramid_window = window;
+                    N_columns = (int)window.count;
+                    x_min = window.xmin;
+                    x_max = window.xmax;
+                }
+
+                columns = s_pyramid_columns.data();
+                texture = &s_pyramid_texture;
+            }
+
+            // Plotagem do espectrograma: um único quad texturizado, desenhado na GPU
+            if (texture->valid() && N_columns > 0 && N_freqs > 0) {
+                ImTextureID image = (ImTextureID)texture->render(s_min_magnitude, s_max_magnitude);
+                ImPlot::PlotImage("##SpectrogramData", image, ImPlotPoint(x_min, 0), ImPlotPoint(x_max, N_freqs));
+            }
+            // Sem textura: colunas contíguas, da mais antiga para a mais recente
+            else if (N_columns > 0 && N_freqs > 0) {
+                ImPlot::PlotHeatmap(
+                    "##SpectrogramData",                    // Label
+                    columns,                                // Dados de magnitude (Z), uma coluna por iteração
+                    N_freqs,                                // Número de linhas (frequências)
+                    N_columns,                              // Número de colunas (tempo/amostras)
+                    s_min_magnitude, s_max_magnitude,       // Limites Z (Magnitude Min/Max em dB)
+                    nullptr,                                // Formato do texto (opcional)
+                    ImPlotPoint(x_min, N_freqs),            // Ponto de início (X_min, Y_min)
+                    ImPlotPoint(x_max, 0),                  // Ponto de fim (X_max, Y_max)
+                    ImPlotHeatmapFlags_ColMajor             // Memória organizada por coluna
+                );
             }
-            
-            // Converte o vetor de std::string para o formato exigido pelo ImPlot (const char* const*)
-            std::vector<const char*> y_ticks_labels_c_str = convert_to_c_str_array(y_ticks_labels_str);
-            
-            ImPlot::SetupAxisTicks(ImAxis_Y1, y_ticks_pos.data(), N_freqs, y_ticks_labels_c_str.data());
-
-            // Plotagem do espectrograma
-            ImPlot::PlotHeatmap(
-                "##SpectrogramData",                    // Label
-                sorted_heatmap_data.data(),             // Dados de magnitude em dB (Z)
-                N_freqs,                                // Número de linhas (frequências)
-                N_history,                              // Número de colunas (tempo/amostras)
-                s_min_magnitude, s_max_magnitude,       // Limites Z (Magnitude Min/Max em dB)
-                nullptr,                                // Formato do texto (opcional)
-                ImPlotPoint(0, N_freqs),                // Ponto de início (X_min, Y_min)
-                ImPlotPoint(N_history, 0)               // Ponto de fim (X_max, Y_max)
-            );
             
             ImPlot::EndPlot();
         }
@@ -568,8 +899,132 @@ void FrontEnd::Application::showOverallVisualizationPage() {
     ImGui::Separator();
 }
 
+// Página de desempenho: custo de cada etapa e latência do áudio até a tela
+void FrontEnd::Application::showPerformancePage() {
+    TRACE_SCOPE("FrontEnd::showPerformancePage");
+    ImGui::Text("Desempenho do Sistema");
+    ImGui::Separator();
+    ImGui::Spacing();
+
+    ImGui::Text("Resultados descartados pela interface: %llu", (unsigned long long)Scheduler::drops());
+    ImGui::SameLine();
+    if (ImGui::Button("Limpar")) {
+        Telemetry::clear();
+        Scheduler::deadline().clear();
+    }
+
+    // Prazo de cada quadro e a política de qualidade adaptativa
+    Deadline& deadline = Scheduler::deadline();
+    ImGui::Text("Prazo de %.2f ms: %llu de %llu quadros perdidos, carga %.0f%%, nível de qualidade %zu",
+        Deadline::PERIOD * 1e-6, (unsigned long long)deadline.misses(), (unsigned long long)deadline.frames(),
+        deadline.load() * 100.0f, deadline.level());
+    bool adaptive = deadline.adaptive();
+    if (ImGui::Checkbox("Reduzir a qualidade sob carga", &adaptive))
+        deadline.setAdaptive(adaptive);
+
+    // Motor dos analisadores: automático escolhe pelo número e espaçamento deles;
+    // multitaxa roda os graves sobre a entrada decimada
+    const char* engines[] = {"Automático", "Goertzel", "FFT", "Multitaxa"};
+    if (ImGui::Combo("Motor", &s_engine, engines, IM_ARRAYSIZE(engines)))
+        BackEnd::setEngine((SpectrumBank::Engine)s_engine);
+    ImGui::SameLine();
+    ImGui::Text("em uso: %s", engines[BackEnd::engine()]);
+    if (s_engine == SpectrumBank::MULTIRATE && ImGui::Checkbox("Janelas longas nos níveis decimados", &s_extended))
+        BackEnd::setExtended(s_extended);
+
+    // Linha do tempo no formato do Chrome (abre no ui.perfetto.dev)
+    bool tracing = Trace::enabled();
+    if (ImGui::Checkbox("Gravar linha do tempo", &tracing))
+        Trace::enable(tracing);
+    ImGui::SameLine();
+    ImGui::Text("%zu eventos, %zu descartados", Trace::events(), Trace::dropped());
+#ifndef BAS_TRACE
+    ImGui::SameLine();
+    ImGui::TextDisabled("(compilado sem -DTRACE=ON)");
+#endif
+    if (!s_trace_path.empty()) {
+        ImGui::SameLine();
+        if (ImGui::Button("Salvar trace") && !Trace::write(s_trace_path))
+            std::cerr << "Não foi possível gravar " << s_trace_path << std::endl;
+    }
+
+    // Resumo de todas as métricas
+    if (ImGui::BeginTable("##Telemetry", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Métrica");
+        ImGui::TableSetupColumn("Amostras");
+        ImGui::TableSetupColumn("Média (ms)");
+        ImGui::TableSetupColumn("p50 (ms)");
+        ImGui::TableSetupColumn("p99 (ms)");
+        ImGui::TableSetupColumn("p99.9 (ms)");
+        ImGui::TableSetupColumn("Máximo (ms)");
+        ImGui::TableHeadersRow();
+        for (int metric = 0; metric < Telemetry::METRICS; ++metric) {
+            const Histogram& histogram = Telemetry::histogram((Telemetry::Metric)metric);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(Telemetry::name((Telemetry::Metric)metric));
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", (unsigned long long)histogram.samples());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", histogram.mean() * 1e-6);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", histogram.percentile(0.5) * 1e-6);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", histogram.percentile(0.99) * 1e-6);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", histogram.percentile(0.999) * 1e-6);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", histogram.maximum() * 1e-6);
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::Spacing();
+
+    // Distribuição da métrica escolhida
+    const char* names[Telemetry::METRICS];
+    for (int metric = 0; metric < Telemetry::METRICS; ++metric)
+        names[metric] = Telemetry::name((Telemetry::Metric)metric);
+    ImGui::Combo("Métrica", &s_performance_metric, names, Telemetry::METRICS);
+
+    // Só o trecho entre o primeiro e o último balde ocupados, em escala logarítmica
+    const Histogram& histogram = Telemetry::histogram((Telemetry::Metric)s_performance_metric);
+    size_t first = histogram.size(), last = 0;
+    for (size_t bucket = 0; bucket < histogram.size(); ++bucket) {
+        if (histogram.count(bucket) != 0) {
+            first = std::min(first, bucket);
+            last = bucket;
+        }
+    }
+
+    FrameVector<double> starts{FrameAllocator<double>(s_frame_arena)};
+    FrameVector<double> counts{FrameAllocator<double>(s_frame_arena)};
+    for (size_t bucket = first; bucket <= last && first < histogram.size(); ++bucket) {
+        starts.push_back(std::max<uint64_t>(histogram.lower(bucket), 1) * 1e-6);
+        counts.push_back((double)histogram.count(bucket));
+    }
+
+    if (ImPlot::BeginPlot("##TelemetryHistogram", ImVec2(-1, 300))) {
+        ImPlot::SetupAxes("Duração (ms)", "Ocorrências", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Log10);
+        ImPlot::PlotStairs(names[s_performance_metric], starts.data(), counts.data(), (int)starts.size());
+        ImPlot::EndPlot();
+    }
+}
+
 // Função principal de renderização da interface
 void FrontEnd::Application::render(GLFWwindow* window) {
+    TRACE_SCOPE("FrontEnd::render");
+    // Descarta os temporários do quadro anterior
+    s_frame_arena.reset();
+    uint64_t render_cpu = Telemetry::threadTime();
+#ifdef BAS_ALLOCATION_COUNTER
+    size_t heap_allocations = FrameArena::heapAllocations();
+#endif
+
+    // Atualiza históricos com o que a thread de análise publicou
+    consumeAnalyses();
+
     // Iniciar o frame do ImGui
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
@@ -602,6 +1057,10 @@ void FrontEnd::Application::render(GLFWwindow* window) {
             showVisualizationPage();
             ImGui::EndTabItem();
         }
+        if (ImGui::BeginTabItem("Desempenho")) {
+            showPerformancePage();
+            ImGui::EndTabItem();
+        }
         ImGui::EndTabBar();
     }
 
@@ -617,4 +1076,21 @@ void FrontEnd::Application::render(GLFWwindow* window) {
     glClearColor(0.45f, 0.55f, 0.60f, 1.00f);
     glClear(GL_COLOR_BUFFER_BIT);
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+    // Latência até a tela do resultado mais novo desenhado neste quadro
+    uint64_t drawn = Telemetry::now();
+    if (s_last_published != 0) {
+        Telemetry::record(Telemetry::PUBLISH_TO_DRAW, drawn - s_last_published);
+        if (s_last_captured != 0)
+            Telemetry::record(Telemetry::AUDIO_TO_PIXEL, drawn - s_last_captured);
+        s_last_published = 0;
+    }
+    Telemetry::record(Telemetry::RENDER_CPU, Telemetry::threadTime() - render_cpu);
+
+    // Com -DALLOCATION_COUNTER=ON, avisa quando um quadro usou o heap (só deve acontecer ao mudar analisadores ou a vista)
+#ifdef BAS_ALLOCATION_COUNTER
+    heap_allocations = FrameArena::heapAllocations() - heap_allocations;
+    if (heap_allocations > 0)
+        std::cerr << "FrontEnd.render: " << heap_allocations << " alocações no heap neste quadro" << std::endl;
+#endif
 }
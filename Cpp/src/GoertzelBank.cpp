@@ -0,0 +1,76 @@
+#include "GoertzelBank.hpp"
+
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+void GoertzelBank::rebuild(vector<float> && frequencies){
+    frequency_list = std::move(frequencies);
+
+    //padding lanes keep zero coefficients, their results are never read
+    size_t padded = (frequency_list.size() + PADDING - 1) / PADDING * PADDING;
+    iir_1.assign(padded, 0.0f);
+    fir_1.assign(padded, 0.0f);
+    fir_2.assign(padded, 0.0f);
+    results.assign(padded, 0.0f);
+
+    for(size_t i = 0; i < frequency_list.size(); i++){
+        float radians = 2.0f * M_PI * frequency_list[i] / (float)(SAMPLE_RATE);
+        iir_1[i] = 2.0f * cos(radians);
+        fir_1[i] = cos(radians);
+        fir_2[i] = sin(radians);
+    }
+}
+
+void GoertzelBank::add(const vector<float> & frequencies){
+    for(float frequency : frequencies)
+        if(frequency > SAMPLE_RATE/2)
+            throw(invalid_argument("GoertzelBank.add: frequency must smaller than half of the sample rate: " + to_string(SAMPLE_RATE) + " sps"));
+
+    vector<float> sorted = frequencies;
+    sort(sorted.begin(), sorted.end());
+
+    vector<float> merged;
+    merged.reserve(frequency_list.size() + sorted.size());
+    set_union(frequency_list.begin(), frequency_list.end(), sorted.begin(), sorted.end(), back_inserter(merged));
+    merged.erase(unique(merged.begin(), merged.end()), merged.end());
+    rebuild(std::move(merged));
+}
+
+void GoertzelBank::remove(const vector<float> & frequencies){
+    vector<float> sorted = frequencies;
+    sort(sorted.begin(), sorted.end());
+
+    vector<float> kept;
+    kept.reserve(frequency_list.size());
+    set_difference(frequency_list.begin(), frequency_list.end(), sorted.begin(), sorted.end(), back_inserter(kept));
+    if(kept.size() != frequency_list.size())
+        rebuild(std::move(kept));
+}
+
+void GoertzelBank::clear(){
+    rebuild({});
+}
+
+//index of the frequency, size() when it is not in the bank
+size_t GoertzelBank::find(float frequency) const{
+    auto position = lower_bound(frequency_list.begin(), frequency_list.end(), frequency);
+    if(position == frequency_list.end() || *position != frequency)
+        return frequency_list.size();
+    return position - frequency_list.begin();
+}
+
+size_t GoertzelBank::size() const{
+    return frequency_list.size();
+}
+
+const vector<float> & GoertzelBank::frequencies() const{
+    return frequency_list;
+}
+
+float GoertzelBank::magnitude(size_t index) const{
+    return results[index];
+}
@@ -0,0 +1,80 @@
+#include "HarmonicAnalyzer.hpp"
+
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+HarmonicAnalyzer::HarmonicAnalyzer(float fundamental, size_t harmonics){
+    set(fundamental, harmonics);
+}
+
+void HarmonicAnalyzer::set(float fundamental, size_t harmonics){
+    if(harmonics > MAX_HARMONICS)
+        throw(invalid_argument("HarmonicAnalyzer.set: at most " + to_string(MAX_HARMONICS) + " harmonics"));
+    if(harmonics && (fundamental <= 0 || fundamental > SAMPLE_RATE/2))
+        throw(invalid_argument("HarmonicAnalyzer.set: the fundamental must lie between 0 and half of the sample rate: " + to_string(SAMPLE_RATE) + " sps"));
+
+    count = harmonics;
+    base = fundamental;
+    active = 0;
+    iir_1.fill(0.0f);
+    fir_1.fill(0.0f);
+    fir_2.fill(0.0f);
+    results.fill(0.0f);
+    if(count)
+        retune(fundamental);
+}
+
+bool HarmonicAnalyzer::retune(float fundamental){
+    if(!count || !(fundamental > 0) || fundamental > SAMPLE_RATE/2)
+        return false;
+    base = fundamental;
+    active = min<size_t>(count, size_t(SAMPLE_RATE / 2 / fundamental));
+
+    //recurrence in double, the float rounding would grow with k
+    double w = 2.0 * M_PI * fundamental / SAMPLE_RATE;
+    double c_1 = cos(w), s_1 = sin(w);
+    double c_previous = 1, s_previous = 0;
+    double c = c_1, s = s_1;
+    for(size_t lane = 0; lane < active; lane++){
+        iir_1[lane] = 2.0 * c;
+        fir_1[lane] = c;
+        fir_2[lane] = s;
+
+        double c_next = 2.0 * c_1 * c - c_previous;
+        double s_next = 2.0 * c_1 * s - s_previous;
+        c_previous = c;
+        s_previous = s;
+        c = c_next;
+        s = s_next;
+    }
+    for(size_t lane = active; lane < MAX_HARMONICS; lane++){
+        iir_1[lane] = 0.0f;
+        results[lane] = 0.0f;
+    }
+    return true;
+}
+
+float HarmonicAnalyzer::fundamental() const{
+    return base;
+}
+
+size_t HarmonicAnalyzer::harmonics() const{
+    return count;
+}
+
+float HarmonicAnalyzer::magnitude(size_t harmonic) const{
+    return results[harmonic - 1];
+}
+
+float HarmonicAnalyzer::thd() const{
+    if(!active || results[0] <= 0)
+        return 0;
+    float distortion = 0;
+    for(size_t lane = 1; lane < active; lane++)
+        distortion += results[lane];
+    return sqrt(distortion / results[0]);
+}
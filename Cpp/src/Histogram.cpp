@@ -0,0 +1,79 @@
+#include "Histogram.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+Histogram::Histogram(){
+    clear();
+}
+
+void Histogram::clear(){
+    for(size_t i = 0; i < BUCKETS; i++)
+        counts[i].store(0, memory_order_relaxed);
+    largest.store(0, memory_order_relaxed);
+}
+
+size_t Histogram::size() const{
+    return BUCKETS;
+}
+
+//smallest value that lands in the bucket
+uint64_t Histogram::lower(size_t bucket) const{
+    if(bucket < SUB_BUCKETS)
+        return bucket;
+    size_t shift = (bucket >> SUB_BITS) - 1;
+    return uint64_t((bucket & (SUB_BUCKETS - 1)) + SUB_BUCKETS) << shift;
+}
+
+//largest value that lands in the bucket
+uint64_t Histogram::upper(size_t bucket) const{
+    if(bucket < SUB_BUCKETS)
+        return bucket;
+    size_t shift = (bucket >> SUB_BITS) - 1;
+    return lower(bucket) + ((uint64_t(1) << shift) - 1);
+}
+
+uint64_t Histogram::count(size_t bucket) const{
+    return counts[bucket].load(memory_order_relaxed);
+}
+
+uint64_t Histogram::samples() const{
+    uint64_t n = 0;
+    for(size_t i = 0; i < BUCKETS; i++)
+        n += count(i);
+    return n;
+}
+
+//from the bucket midpoints, as precise as the buckets
+double Histogram::mean() const{
+    uint64_t n = 0;
+    double sum = 0;
+    for(size_t i = 0; i < BUCKETS; i++){
+        uint64_t c = count(i);
+        n += c;
+        sum += double(c) * 0.5 * (double(lower(i)) + double(upper(i)));
+    }
+    return n ? sum / double(n) : 0.0;
+}
+
+uint64_t Histogram::maximum() const{
+    return largest.load(memory_order_relaxed);
+}
+
+//upper edge of the bucket holding the quantile, never above the recorded maximum
+uint64_t Histogram::percentile(double quantile) const{
+    uint64_t n = samples();
+    if(n == 0)
+        return 0;
+
+    uint64_t target = max<uint64_t>(1, uint64_t(ceil(quantile * double(n))));
+    uint64_t seen = 0;
+    for(size_t i = 0; i < BUCKETS; i++){
+        seen += count(i);
+        if(seen >= target)
+            return min(upper(i), maximum());
+    }
+    return maximum();
+}
@@ -0,0 +1,112 @@
+#include "MinMaxHistory.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+//coarsest level keeps at least this many buckets
+static constexpr size_t MIN_BUCKETS = 16;
+
+MinMaxHistory::MinMaxHistory(size_t capacity){
+    //power of two so a bucket never straddles the wrap point
+    length = MIN_BUCKETS;
+    while(length < capacity)
+        length <<= 1;
+
+    memory.emplace_back(2 * length, 0.0f);
+    for(size_t k = 1; (length >> k) >= MIN_BUCKETS; k++)
+        memory.emplace_back(4 * (length >> k), 0.0f);
+}
+
+void MinMaxHistory::push(float sample){
+    size_t slot = total & (length - 1);
+    memory[0][slot] = sample;
+    memory[0][slot + length] = sample;
+
+    for(size_t k = 1; k < memory.size(); k++){
+        size_t buckets = length >> k;
+        slot = (total >> k) & (buckets - 1);
+        float * pair = memory[k].data() + 2 * slot;
+        float * mirror = pair + 2 * buckets;
+
+        //first sample of a bucket resets it, the rest widen it
+        if((total & ((size_t(1) << k) - 1)) == 0){
+            pair[0] = sample;
+            pair[1] = sample;
+        }
+        else{
+            pair[0] = min(pair[0], sample);
+            pair[1] = max(pair[1], sample);
+        }
+        mirror[0] = pair[0];
+        mirror[1] = pair[1];
+    }
+    total++;
+}
+
+void MinMaxHistory::clear(){
+    total = 0;
+}
+
+size_t MinMaxHistory::size() const{
+    return min(total, length);
+}
+
+size_t MinMaxHistory::capacity() const{
+    return length;
+}
+
+bool MinMaxHistory::empty() const{
+    return total == 0;
+}
+
+float MinMaxHistory::back() const{
+    return memory[0][(total - 1) & (length - 1)];
+}
+
+size_t MinMaxHistory::levels() const{
+    return memory.size();
+}
+
+//coarsest level that still gives at least one bucket per pixel
+size_t MinMaxHistory::level(double samples, double pixels) const{
+    size_t k = 0;
+    while(k + 1 < memory.size() && samples / double(size_t(1) << (k + 1)) >= pixels)
+        k++;
+    return k;
+}
+
+MinMaxHistory::Window MinMaxHistory::window(size_t level, double from, double to) const{
+    Window result = {nullptr, 0, 1.0, 0.0};
+    if(total == 0)
+        return result;
+
+    //samples ago -> absolute sample index, clamped to what is still stored
+    double newest = double(total - 1);
+    double oldest = double(total - size());
+    double first = max(oldest, floor(from + newest));
+    double last = min(newest, ceil(to + newest));
+    if(first > last)
+        return result;
+
+    level = min(level, memory.size() - 1);
+    size_t buckets = level == 0 ? length : length >> level;
+    size_t b1 = size_t(last) >> level;
+    size_t b0 = max(size_t(first) >> level, b1 + 1 > buckets ? b1 + 1 - buckets : 0);
+    size_t count = b1 - b0 + 1;
+
+    if(level == 0){
+        result.data = memory[0].data() + (b0 & (length - 1));
+        result.count = count;
+        result.xstart = double(b0) - newest;
+        return result;
+    }
+
+    //two points per bucket, half a bucket apart
+    result.data = memory[level].data() + 2 * (b0 & (buckets - 1));
+    result.count = 2 * count;
+    result.xscale = double(size_t(1) << (level - 1));
+    result.xstart = double(b0 << level) - newest;
+    return result;
+}
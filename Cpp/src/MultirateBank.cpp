@@ -0,0 +1,149 @@
+#include "MultirateBank.hpp"
+
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+//windowed sinc half-band (Blackman), normalized to unit gain at DC
+MultirateBank::MultirateBank(){
+    const size_t center = (TAPS - 1) / 2;
+    float sum = 0;
+    for(size_t j = 0; j < taps.size(); j++){
+        size_t offset = 2 * j + 1;
+        double x = M_PI * offset / 2.0;
+        double position = 2.0 * M_PI * (center + offset) / (TAPS - 1);
+        double window = 0.42 - 0.5 * cos(position) + 0.08 * cos(2.0 * position);
+        taps[j] = 0.5 * sin(x) / x * window;
+        sum += taps[j];
+    }
+    for(float & tap : taps)
+        tap *= 0.25f / sum;
+}
+
+void MultirateBank::rebuild(vector<float> && frequencies){
+    frequency_list = std::move(frequencies);
+    results.assign(frequency_list.size(), 0.0f);
+
+    array<vector<float>,LEVELS + 1> scaled;
+    for(Level & level : levels)
+        level.analyzers.clear();
+    for(size_t i = 0; i < frequency_list.size(); i++){
+        size_t l = level(frequency_list[i]);
+        scaled[l].push_back(frequency_list[i] * float(size_t(1) << l));
+        levels[l].analyzers.push_back(i);
+    }
+
+    //levels that start running now begin from silence, not from whatever they held last
+    size_t previous = depth;
+    depth = 0;
+    for(size_t l = 0; l <= LEVELS; l++){
+        levels[l].bank.clear();
+        levels[l].bank.add(scaled[l]);
+        if(!scaled[l].empty())
+            depth = l;
+    }
+    for(size_t l = previous + 1; l <= depth; l++){
+        fill(levels[l].input.begin(), levels[l].input.end(), 0.0f);
+        fill(levels[l].window.begin(), levels[l].window.end(), 0.0f);
+    }
+}
+
+void MultirateBank::prepare(size_t frame){
+    this->frame = frame;
+    for(size_t l = 1; l <= LEVELS; l++){
+        Level & level = levels[l];
+        level.input.assign(TAPS - 1 + (frame >> (l - 1)), 0.0f);
+        level.output.assign(frame >> l, 0.0f);
+        level.window.assign(extended ? frame : frame >> l, 0.0f);
+    }
+}
+
+//one half-band stage: `count` samples in, count / 2 out, the odd taps only
+void MultirateBank::decimate(Level & level, const float * samples, size_t count){
+    float * input = level.input.data();
+    copy(samples, samples + count, input + TAPS - 1);
+
+    const size_t center = (TAPS - 1) / 2;
+    for(size_t m = 0; m < count / 2; m++){
+        const float * x = input + 2 * m + center;
+        float y = 0.5f * x[0];
+        for(size_t j = 0; j < taps.size(); j++)
+            y += taps[j] * (x[-ptrdiff_t(2 * j + 1)] + x[2 * j + 1]);
+        level.output[m] = y;
+    }
+    copy(input + count, input + count + TAPS - 1, input);
+}
+
+//deepest level whose usable band holds the frequency
+size_t MultirateBank::level(float frequency){
+    size_t level = 0;
+    while(level < LEVELS && frequency <= COVERAGE * SAMPLE_RATE / float(size_t(4) << level))
+        level++;
+    return level;
+}
+
+void MultirateBank::add(const vector<float> & frequencies){
+    for(float frequency : frequencies)
+        if(frequency > SAMPLE_RATE/2)
+            throw(invalid_argument("MultirateBank.add: frequency must smaller than half of the sample rate: " + to_string(SAMPLE_RATE) + " sps"));
+
+    vector<float> sorted = frequencies;
+    sort(sorted.begin(), sorted.end());
+
+    vector<float> merged;
+    merged.reserve(frequency_list.size() + sorted.size());
+    set_union(frequency_list.begin(), frequency_list.end(), sorted.begin(), sorted.end(), back_inserter(merged));
+    merged.erase(unique(merged.begin(), merged.end()), merged.end());
+    rebuild(std::move(merged));
+}
+
+void MultirateBank::remove(const vector<float> & frequencies){
+    vector<float> sorted = frequencies;
+    sort(sorted.begin(), sorted.end());
+
+    vector<float> kept;
+    kept.reserve(frequency_list.size());
+    set_difference(frequency_list.begin(), frequency_list.end(), sorted.begin(), sorted.end(), back_inserter(kept));
+    if(kept.size() != frequency_list.size())
+        rebuild(std::move(kept));
+}
+
+void MultirateBank::clear(){
+    rebuild({});
+}
+
+//index of the frequency, size() when it is not in the bank
+size_t MultirateBank::find(float frequency) const{
+    auto position = lower_bound(frequency_list.begin(), frequency_list.end(), frequency);
+    if(position == frequency_list.end() || *position != frequency)
+        return frequency_list.size();
+    return position - frequency_list.begin();
+}
+
+size_t MultirateBank::size() const{
+    return frequency_list.size();
+}
+
+const vector<float> & MultirateBank::frequencies() const{
+    return frequency_list;
+}
+
+float MultirateBank::magnitude(size_t index) const{
+    return results[index];
+}
+
+//resizes the windows, the deep levels refill over the next 2^level frames
+void MultirateBank::setExtended(bool extended){
+    if(this->extended == extended)
+        return;
+    this->extended = extended;
+    if(frame)
+        prepare(frame);
+}
+
+bool MultirateBank::isExtended() const{
+    return extended;
+}
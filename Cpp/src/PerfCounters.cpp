@@ -0,0 +1,189 @@
+#include "PerfCounters.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+std::atomic<bool> PerfCounters::on = false;
+PerfCounters::Totals PerfCounters::totals[STAGES];
+
+static const char * NAMES[PerfCounters::STAGES] = {
+    "analyzer banks",
+    "chirp-z bands",
+    "harmonics",
+    "wbas.execute",
+    "sos"
+};
+
+static const uint64_t EVENTS[PerfCounters::COUNTERS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+static const char * EVENT_NAMES[PerfCounters::COUNTERS] = {
+    "cycles",
+    "instructions",
+    "cache misses",
+    "branch misses"
+};
+
+namespace{
+    // the first refusal turns the counters off for every thread
+    std::atomic<bool> refused = false;
+    char refusal[160] = "";
+
+    struct Group{
+        int fds[PerfCounters::COUNTERS];
+        bool tried = false;
+        bool opened = false;
+
+        ~Group(){
+            if(opened)
+                for(int fd : fds)
+                    close(fd);
+        }
+
+        bool open(){
+            if(tried)
+                return opened;
+            tried = true;
+            if(refused.load(std::memory_order_relaxed))
+                return false;
+
+            for(size_t i = 0; i < PerfCounters::COUNTERS; i++){
+                perf_event_attr attr;
+                memset(&attr, 0, sizeof(attr));
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.size = sizeof(attr);
+                attr.config = EVENTS[i];
+                attr.disabled = i == 0;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_GROUP;
+
+                fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds[0], 0);
+                if(fds[i] < 0){
+                    if(!refused.exchange(true))
+                        snprintf(refusal, sizeof(refusal), "perf_event_open(%s): %s", EVENT_NAMES[i], strerror(errno));
+                    for(size_t j = 0; j < i; j++)
+                        close(fds[j]);
+                    return false;
+                }
+            }
+
+            ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            opened = true;
+            return true;
+        }
+    };
+
+    thread_local Group group;
+}
+
+PerfCounters::Scope::Scope(Stage stage, size_t samples) : stage(stage), samples(samples), active(enabled() && read(start)){}
+
+PerfCounters::Scope::~Scope(){
+    Reading end;
+    if(!active || !read(end))
+        return;
+    for(size_t i = 0; i < COUNTERS; i++)
+        end.values[i] -= start.values[i];
+    add(stage, end, samples);
+}
+
+void PerfCounters::enable(bool on){
+    PerfCounters::on.store(on, std::memory_order_relaxed);
+}
+
+//probes on the calling thread
+bool PerfCounters::available(){
+    return group.open();
+}
+
+const char * PerfCounters::reason(){
+    return refused.load() ? refusal : "";
+}
+
+bool PerfCounters::read(Reading & reading){
+    if(!group.open())
+        return false;
+
+    struct{
+        uint64_t count;
+        uint64_t values[COUNTERS];
+    } group_reading;
+    if(::read(group.fds[0], &group_reading, sizeof(group_reading)) != sizeof(group_reading) || group_reading.count != COUNTERS)
+        return false;
+
+    for(size_t i = 0; i < COUNTERS; i++)
+        reading.values[i] = group_reading.values[i];
+    return true;
+}
+
+void PerfCounters::add(Stage stage, const Reading & delta, size_t samples){
+    Totals & stage_totals = totals[stage];
+    for(size_t i = 0; i < COUNTERS; i++)
+        stage_totals.values[i].fetch_add(delta.values[i], std::memory_order_relaxed);
+    stage_totals.samples.fetch_add(samples, std::memory_order_relaxed);
+    stage_totals.calls.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t PerfCounters::total(Stage stage, Counter counter){
+    return totals[stage].values[counter].load(std::memory_order_relaxed);
+}
+
+uint64_t PerfCounters::samples(Stage stage){
+    return totals[stage].samples.load(std::memory_order_relaxed);
+}
+
+uint64_t PerfCounters::calls(Stage stage){
+    return totals[stage].calls.load(std::memory_order_relaxed);
+}
+
+const char * PerfCounters::name(Stage stage){
+    return NAMES[stage];
+}
+
+void PerfCounters::clear(){
+    for(Totals & stage_totals : totals){
+        for(auto & value : stage_totals.values)
+            value.store(0, std::memory_order_relaxed);
+        stage_totals.samples.store(0, std::memory_order_relaxed);
+        stage_totals.calls.store(0, std::memory_order_relaxed);
+    }
+}
+
+//one line per stage that ran, counts per input sample
+void PerfCounters::print(FILE * file, const char * prefix){
+    if(refused.load()){
+        fprintf(file, "%shardware counters unavailable: %s\n", prefix, refusal);
+        fflush(file);
+        return;
+    }
+
+    fprintf(file, "%s%-16s %10s %8s %12s %12s %14s %14s\n", prefix, "stage", "calls", "ipc",
+        "cycles/smp", "instr/smp", "cache_miss/smp", "branch_miss/smp");
+    for(size_t stage = 0; stage < STAGES; stage++){
+        uint64_t count = samples(Stage(stage));
+        if(!count)
+            continue;
+        uint64_t cycles = total(Stage(stage), CYCLES);
+        fprintf(file, "%s%-16s %10llu %8.2f %12.2f %12.2f %14.4f %14.4f\n",
+            prefix,
+            NAMES[stage],
+            (unsigned long long)calls(Stage(stage)),
+            cycles ? double(total(Stage(stage), INSTRUCTIONS)) / cycles : 0.0,
+            double(cycles) / count,
+            double(total(Stage(stage), INSTRUCTIONS)) / count,
+            double(total(Stage(stage), CACHE_MISSES)) / count,
+            double(total(Stage(stage), BRANCH_MISSES)) / count
+        );
+    }
+    fflush(file);
+}
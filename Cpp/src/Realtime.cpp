@@ -0,0 +1,107 @@
+#include "Realtime.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <alloca.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+using namespace std;
+
+static const char * policyName(int policy){
+    return policy == SCHED_FIFO ? "SCHED_FIFO" : policy == SCHED_RR ? "SCHED_RR" : "SCHED_OTHER";
+}
+
+//touches the pages below the current frame so later calls do not fault
+static void prefaultStack(size_t size){
+    volatile char * stack = (volatile char *)alloca(size);
+    for(size_t i = 0; i < size; i += 4096)
+        stack[i] = 0;
+}
+
+int Realtime::policy(const string & name){
+    if(name == "fifo")
+        return SCHED_FIFO;
+    if(name == "rr")
+        return SCHED_RR;
+    if(name == "other")
+        return SCHED_OTHER;
+    return -1;
+}
+
+vector<string> Realtime::applyProcess(const Profile & profile){
+    vector<string> report;
+    if(!profile.lock_memory)
+        return report;
+
+    //without MCL_FUTURE later allocations may still fault, but what exists now stays resident
+    if(mlockall(MCL_CURRENT | MCL_FUTURE) == 0)
+        report.push_back("memory locked, current and future mappings");
+    else if(int error = errno; mlockall(MCL_CURRENT) == 0)
+        report.push_back(string("memory locked, current mappings only (") + strerror(error) + ")");
+    else
+        report.push_back(string("memory not locked: ") + strerror(errno));
+    return report;
+}
+
+vector<string> Realtime::applyThread(const Profile & profile){
+    vector<string> report;
+
+    if(!profile.cpus.empty()){
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        string requested;
+        for(int cpu : profile.cpus){
+            if(cpu >= 0 && cpu < CPU_SETSIZE)
+                CPU_SET(cpu, &set);
+            requested += (requested.empty() ? "" : ",") + to_string(cpu);
+        }
+
+        //the kernel keeps only the online cpus of the set, report those
+        int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if(error == 0 && pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0){
+            string cpus;
+            for(int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+                if(CPU_ISSET(cpu, &set))
+                    cpus += (cpus.empty() ? "" : ",") + to_string(cpu);
+            report.push_back("pinned to cpus " + cpus + " (asked for " + requested + ")");
+        }
+        else
+            report.push_back("not pinned to cpus " + requested + ": " + strerror(error ? error : errno));
+    }
+
+    if(profile.policy == SCHED_FIFO || profile.policy == SCHED_RR){
+        sched_param parameters = {};
+        parameters.sched_priority = max(sched_get_priority_min(profile.policy), min(profile.priority, sched_get_priority_max(profile.policy)));
+        int error = pthread_setschedparam(pthread_self(), profile.policy, &parameters);
+        if(error == 0)
+            report.push_back(string(policyName(profile.policy)) + " priority " + to_string(parameters.sched_priority));
+        else
+            report.push_back(string(policyName(profile.policy)) + " refused, staying SCHED_OTHER: " + strerror(error));
+    }
+
+    if(profile.flush_denormals){
+#if defined(__SSE__)
+        _mm_setcsr(_mm_getcsr() | 0x8040);     // FTZ | DAZ
+        report.push_back("denormals flushed to zero (FTZ/DAZ)");
+#elif defined(__aarch64__)
+        uint64_t fpcr;
+        __asm__ volatile("mrs %0, fpcr" : "=r"(fpcr));
+        __asm__ volatile("msr fpcr, %0" :: "r"(fpcr | (1ull << 24)));
+        report.push_back("denormals flushed to zero (FPCR.FZ)");
+#else
+        report.push_back("denormals kept, no flush to zero on this architecture");
+#endif
+    }
+
+    if(profile.stack){
+        prefaultStack(profile.stack);
+        report.push_back("stack prefaulted, " + to_string(profile.stack / 1024) + " KiB");
+    }
+    return report;
+}
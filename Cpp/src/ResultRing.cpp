@@ -0,0 +1,214 @@
+#include "ResultRing.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+static constexpr size_t ALIGNMENT = 64;
+
+static size_t align(size_t size){
+    return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+ResultRingWriter::ResultRingWriter(const string & name, const vector<float> & frequencies, size_t slots) : name(name){
+    if(slots == 0)
+        throw invalid_argument("ResultRingWriter.constructor: the ring needs at least one slot");
+
+    size_t frequencies_offset = align(sizeof(ResultRingHeader));
+    size_t slots_offset = frequencies_offset + align(frequencies.size() * sizeof(float));
+    size_t slot_size = align(sizeof(ResultSlot) + frequencies.size() * sizeof(float));
+    length = slots_offset + slots * slot_size;
+
+    //a previous writer's segment is never truncated under its readers: they keep
+    //the old inode until they reopen, the name goes to a fresh segment
+    if(shm_unlink(name.data()) < 0 && errno != ENOENT)
+        throw runtime_error("ResultRingWriter.constructor: shm_unlink " + name + ": " + strerror(errno));
+
+    int descriptor = shm_open(name.data(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if(descriptor < 0)
+        throw runtime_error("ResultRingWriter.constructor: shm_open " + name + ": " + strerror(errno));
+
+    struct stat status;
+    if(fstat(descriptor, &status) < 0 || ftruncate(descriptor, length) < 0){
+        int error = errno;
+        close(descriptor);
+        shm_unlink(name.data());
+        throw runtime_error("ResultRingWriter.constructor: fstat/ftruncate " + name + ": " + strerror(error));
+    }
+
+    void * mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if(mapping == MAP_FAILED)
+        throw runtime_error("ResultRingWriter.constructor: mmap " + name + ": " + strerror(errno));
+
+    memory = static_cast<uint8_t*>(mapping);
+    header = reinterpret_cast<ResultRingHeader*>(memory);
+    device = status.st_dev;
+    inode = status.st_ino;
+    header->version = RESULT_RING_VERSION;
+    header->analyzers = frequencies.size();
+    header->slots = slots;
+    header->slot_size = slot_size;
+    header->frequencies_offset = frequencies_offset;
+    header->slots_offset = slots_offset;
+    header->closed.store(0, memory_order_relaxed);
+    header->head.store(0, memory_order_relaxed);
+    memcpy(memory + frequencies_offset, frequencies.data(), frequencies.size() * sizeof(float));
+
+    //readers refuse the segment until the magic shows up
+    header->magic.store(RESULT_RING_MAGIC, memory_order_release);
+}
+
+ResultRingWriter::~ResultRingWriter(){
+    if(memory){
+        header->closed.store(1, memory_order_release);
+        munmap(memory, length);
+
+        //the name may belong to a newer writer by now
+        int descriptor = shm_open(name.data(), O_RDONLY, 0);
+        if(descriptor >= 0){
+            struct stat status;
+            bool ours = fstat(descriptor, &status) == 0 && status.st_dev == device && status.st_ino == inode;
+            close(descriptor);
+            if(ours)
+                shm_unlink(name.data());
+        }
+    }
+}
+
+void ResultRingWriter::publish(uint64_t timestamp, pair<float,float> peak, const float * magnitudes){
+    ResultSlot * slot = reinterpret_cast<ResultSlot*>(memory + header->slots_offset + (frame % header->slots) * header->slot_size);
+
+    slot->sequence.store(2 * frame + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    slot->timestamp = timestamp;
+    slot->peak_frequency = peak.first;
+    slot->peak_magnitude = peak.second;
+    memcpy(reinterpret_cast<uint8_t*>(slot) + sizeof(ResultSlot), magnitudes, header->analyzers * sizeof(float));
+
+    slot->sequence.store(2 * frame + 2, memory_order_release);
+    header->head.store(++frame, memory_order_release);
+}
+
+ResultRingReader::ResultRingReader(const string & name) : name(name){
+    reopen();
+}
+
+ResultRingReader::~ResultRingReader(){
+    munmap(const_cast<uint8_t*>(memory), length);
+}
+
+//maps whatever segment the name points to now, the current one stays on failure
+void ResultRingReader::reopen(){
+    int descriptor = shm_open(name.data(), O_RDONLY, 0);
+    if(descriptor < 0)
+        throw runtime_error("ResultRingReader.reopen: shm_open " + name + ": " + strerror(errno));
+
+    struct stat status;
+    if(fstat(descriptor, &status) < 0 || (size_t)status.st_size < sizeof(ResultRingHeader)){
+        close(descriptor);
+        throw runtime_error("ResultRingReader.reopen: " + name + " is not a result ring");
+    }
+
+    size_t size = status.st_size;
+    void * mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if(mapping == MAP_FAILED)
+        throw runtime_error("ResultRingReader.reopen: mmap " + name + ": " + strerror(errno));
+
+    const ResultRingHeader * mapped = static_cast<const ResultRingHeader*>(mapping);
+    if(mapped->magic.load(memory_order_acquire) != RESULT_RING_MAGIC || mapped->version != RESULT_RING_VERSION
+    || mapped->slots_offset + (size_t)mapped->slots * mapped->slot_size > size){
+        munmap(mapping, size);
+        throw runtime_error("ResultRingReader.reopen: " + name + " has an unknown layout or version");
+    }
+
+    if(memory)
+        munmap(const_cast<uint8_t*>(memory), length);
+    memory = static_cast<const uint8_t*>(mapping);
+    length = size;
+    header = mapped;
+    device = status.st_dev;
+    inode = status.st_ino;
+    cursor = head();
+}
+
+bool ResultRingReader::replaced() const{
+    if(header->closed.load(memory_order_acquire))
+        return true;
+
+    int descriptor = shm_open(name.data(), O_RDONLY, 0);
+    if(descriptor < 0)
+        return errno == ENOENT;
+
+    struct stat status;
+    bool other = fstat(descriptor, &status) == 0 && (status.st_dev != device || status.st_ino != inode);
+    close(descriptor);
+    return other;
+}
+
+const ResultSlot * ResultRingReader::slot(uint64_t sequence) const{
+    return reinterpret_cast<const ResultSlot*>(memory + header->slots_offset + (sequence % header->slots) * header->slot_size);
+}
+
+size_t ResultRingReader::analyzers() const{
+    return header->analyzers;
+}
+
+size_t ResultRingReader::slots() const{
+    return header->slots;
+}
+
+const float * ResultRingReader::frequencies() const{
+    return reinterpret_cast<const float*>(memory + header->frequencies_offset);
+}
+
+uint64_t ResultRingReader::head() const{
+    return header->head.load(memory_order_acquire);
+}
+
+bool ResultRingReader::acquire(uint64_t sequence, Frame & frame) const{
+    const ResultSlot * current = slot(sequence);
+    if(current->sequence.load(memory_order_acquire) != 2 * sequence + 2)
+        return false;
+
+    frame.sequence = sequence;
+    frame.timestamp = current->timestamp;
+    frame.peak_frequency = current->peak_frequency;
+    frame.peak_magnitude = current->peak_magnitude;
+    frame.magnitudes = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(current) + sizeof(ResultSlot));
+    return true;
+}
+
+bool ResultRingReader::consistent(const Frame & frame) const{
+    atomic_thread_fence(memory_order_acquire);
+    return slot(frame.sequence)->sequence.load(memory_order_relaxed) == 2 * frame.sequence + 2;
+}
+
+bool ResultRingReader::next(Frame & frame){
+    uint64_t published = head();
+
+    //older frames are gone, the oldest kept one may be under rewrite already (acquire tells)
+    if(published - cursor > header->slots){
+        lost += published - cursor - header->slots;
+        cursor = published - header->slots;
+    }
+
+    while(cursor < published){
+        if(acquire(cursor++, frame))
+            return true;
+        lost++;
+    }
+    return false;
+}
+
+uint64_t ResultRingReader::skipped() const{
+    return lost;
+}
@@ -0,0 +1,124 @@
+#include "Scheduler.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+
+using namespace std;
+
+thread Scheduler::worker;
+atomic<bool> Scheduler::running = false;
+function<void()> Scheduler::notify;
+
+mutex Scheduler::lock;
+array<Analysis,Scheduler::QUEUE> Scheduler::queue;
+array<Analysis,Scheduler::QUEUE> Scheduler::consumed;
+size_t Scheduler::head = 0;
+size_t Scheduler::count = 0;
+uint64_t Scheduler::dropped = 0;
+Deadline Scheduler::monitor;
+Realtime::Profile Scheduler::profile;
+
+void Scheduler::setRealtime(const Realtime::Profile & profile){
+    Scheduler::profile = profile;
+}
+
+void Scheduler::start(function<void()> notify){
+    if(running)
+        return;
+    for(const string & line : Realtime::applyProcess(profile))
+        fprintf(stderr, "Scheduler: realtime: %s\n", line.data());
+    Scheduler::notify = notify;
+    running = true;
+    worker = thread(work);
+}
+
+void Scheduler::stop(){
+    if(!running)
+        return;
+    running = false;
+    worker.join();
+}
+
+//the analyzer set lives in BackEnd, each analysis carries a copy of it
+void Scheduler::addFrequency(float frequency){
+    BackEnd::createAnalyzer(frequency);
+}
+
+void Scheduler::removeFrequency(float frequency){
+    BackEnd::destroyAnalyzer(frequency);
+}
+
+void Scheduler::addFrequencies(const vector<float>& frequencies, bool low_priority){
+    BackEnd::createAnalyzers(frequencies, low_priority);
+}
+
+void Scheduler::removeFrequencies(const vector<float>& frequencies){
+    BackEnd::destroyAnalyzers(frequencies);
+}
+
+uint64_t Scheduler::addBand(float start, float stop, size_t bins){
+    return BackEnd::createBand(start, stop, bins);
+}
+
+uint64_t Scheduler::removeBand(size_t index){
+    return BackEnd::destroyBand(index);
+}
+
+void Scheduler::setHarmonics(float fundamental, size_t count, bool track){
+    BackEnd::setHarmonics(fundamental, count, track);
+}
+
+uint64_t Scheduler::drops(){
+    lock_guard<mutex> guard(lock);
+    return dropped;
+}
+
+Deadline & Scheduler::deadline(){
+    return monitor;
+}
+
+void Scheduler::work(){
+    Analysis current;
+    uint64_t sequence = 0;
+    Trace::thread("analysis");
+    for(const string & line : Realtime::applyThread(profile))
+        fprintf(stderr, "Scheduler: realtime: %s\n", line.data());
+    while(running){
+        //blocks for one frame, this is what paces the loop
+        BackEnd::update();
+        uint64_t start = Telemetry::now();
+        uint64_t cpu = Telemetry::threadTime();
+        current.captured = BackEnd::captureTime();
+        current.timestamp = chrono::duration_cast<chrono::nanoseconds>(chrono::system_clock::now().time_since_epoch()).count();
+
+        //the peak first, a tracking harmonic analyzer follows it on this same frame
+        current.peak = BackEnd::maximum();
+        BackEnd::queryFrequencies(current.frequencies, current.magnitudes);
+        current.band_generation = BackEnd::queryBands(current.bands);
+        BackEnd::queryHarmonics(current.harmonics);
+        current.sequence = ++sequence;
+        current.published = Telemetry::now();
+        Telemetry::record(Telemetry::ANALYSIS_CPU, Telemetry::threadTime() - cpu);
+
+        Telemetry::Scope scope(Telemetry::PUBLISH);
+        bool idle = current.frequencies.empty() && current.bands.empty() && current.harmonics.magnitudes.empty();
+        {
+            lock_guard<mutex> guard(lock);
+            if(count == QUEUE){
+                head = (head + 1) % QUEUE;
+                count--;
+                dropped++;
+            }
+            swap(queue[(head + count) % QUEUE], current);
+            count++;
+        }
+
+        if(notify && !idle)
+            notify();
+
+        //the next frame is already being captured, only its analysis gets cheaper
+        if(monitor.frame(Telemetry::now() - start))
+            BackEnd::setQuality(monitor.quality());
+    }
+}
@@ -0,0 +1,251 @@
+#include "SocketServer.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/uio.h>
+#include <sys/socket.h>
+
+using namespace std;
+
+static constexpr size_t IOVECS = 64;
+
+SocketServer::SocketServer(const string & path, const vector<float> & frequencies, size_t batch, size_t queue) :
+    path(path),
+    analyzers(frequencies.size()),
+    batch(batch),
+    queue(queue),
+    frame_size(sizeof(SocketFrame) + frequencies.size() * sizeof(float))
+{
+    if(batch == 0 || queue == 0)
+        throw invalid_argument("SocketServer.constructor: batch and queue must be at least 1");
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if(path.size() >= sizeof(address.sun_path))
+        throw invalid_argument("SocketServer.constructor: socket path too long: " + path);
+    strcpy(address.sun_path, path.data());
+
+    listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(listener < 0)
+        throw runtime_error("SocketServer.constructor: socket: " + string(strerror(errno)));
+
+    unlink(path.data());
+    if(bind(listener, (sockaddr*)&address, sizeof(address)) < 0 || listen(listener, 16) < 0){
+        int error = errno;
+        close(listener);
+        throw runtime_error("SocketServer.constructor: bind " + path + ": " + strerror(error));
+    }
+
+    auto greeting = make_shared<Buffer>(sizeof(SocketHello) + analyzers * sizeof(float));
+    SocketHello header = {SOCKET_HELLO_MAGIC, SOCKET_VERSION, (uint32_t)analyzers, (uint32_t)batch};
+    memcpy(greeting->data(), &header, sizeof(header));
+    memcpy(greeting->data() + sizeof(header), frequencies.data(), analyzers * sizeof(float));
+    hello = greeting;
+
+    current = acquire();
+}
+
+SocketServer::~SocketServer(){
+    if(filled)
+        dispatch();
+    for(Client & client : clients)
+        close(client.descriptor);
+    close(listener);
+    unlink(path.data());
+}
+
+shared_ptr<SocketServer::Buffer> SocketServer::acquire(){
+    //a buffer nobody else references anymore went through every client
+    for(auto & buffer : pool)
+        if(buffer.use_count() == 1){
+            buffer->resize(sizeof(SocketBatch) + batch * frame_size);
+            return buffer;
+        }
+    pool.push_back(make_shared<Buffer>(sizeof(SocketBatch) + batch * frame_size));
+    return pool.back();
+}
+
+void SocketServer::accept(){
+    int descriptor;
+    while((descriptor = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+        clients.push_back({descriptor, 0, {hello}});
+}
+
+bool SocketServer::flush(Client & client){
+    while(!client.pending.empty()){
+        iovec vectors[IOVECS];
+        size_t count = 0;
+        for(auto & buffer : client.pending){
+            if(count == IOVECS)
+                break;
+            size_t offset = count == 0 ? client.offset : 0;
+            vectors[count++] = {(void*)(buffer->data() + offset), buffer->size() - offset};
+        }
+
+        msghdr message = {};
+        message.msg_iov = vectors;
+        message.msg_iovlen = count;
+        ssize_t sent = sendmsg(client.descriptor, &message, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if(sent < 0)
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+
+        size_t remaining = sent;
+        while(remaining){
+            size_t left = client.pending.front()->size() - client.offset;
+            if(remaining < left){
+                client.offset += remaining;
+                break;
+            }
+            remaining -= left;
+            client.offset = 0;
+            client.pending.pop_front();
+        }
+
+        //socket buffer full, the rest waits for the next batch
+        if(client.offset)
+            return true;
+    }
+    return true;
+}
+
+void SocketServer::dispatch(){
+    SocketBatch header = {SOCKET_BATCH_MAGIC, (uint32_t)filled, sequence - filled};
+    memcpy(current->data(), &header, sizeof(header));
+    current->resize(sizeof(SocketBatch) + filled * frame_size);
+
+    accept();
+    for(size_t i = 0; i < clients.size();){
+        Client & client = clients[i];
+        client.pending.push_back(current);
+
+        //backpressure: drop whole batches, never the greeting or one that is half sent
+        while(client.pending.size() > queue){
+            size_t oldest = client.offset || client.pending.front() == hello ? 1 : 0;
+            client.pending.erase(client.pending.begin() + oldest);
+            dropped++;
+        }
+
+        if(flush(client))
+            i++;
+        else{
+            close(client.descriptor);
+            clients[i] = std::move(clients.back());
+            clients.pop_back();
+        }
+    }
+
+    current = acquire();
+    filled = 0;
+}
+
+void SocketServer::publish(uint64_t timestamp, pair<float,float> peak, const float * magnitudes){
+    uint8_t * slot = current->data() + sizeof(SocketBatch) + filled * frame_size;
+    SocketFrame frame = {timestamp, peak.first, peak.second};
+    memcpy(slot, &frame, sizeof(frame));
+    memcpy(slot + sizeof(frame), magnitudes, analyzers * sizeof(float));
+    sequence++;
+
+    if(++filled == batch)
+        dispatch();
+}
+
+size_t SocketServer::connections() const{
+    return clients.size();
+}
+
+uint64_t SocketServer::drops() const{
+    return dropped;
+}
+
+SocketClient::SocketClient(const string & path){
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if(path.size() >= sizeof(address.sun_path))
+        throw invalid_argument("SocketClient.constructor: socket path too long: " + path);
+    strcpy(address.sun_path, path.data());
+
+    descriptor = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(descriptor < 0)
+        throw runtime_error("SocketClient.constructor: socket: " + string(strerror(errno)));
+    if(connect(descriptor, (sockaddr*)&address, sizeof(address)) < 0){
+        int error = errno;
+        close(descriptor);
+        throw runtime_error("SocketClient.constructor: connect " + path + ": " + strerror(error));
+    }
+
+    SocketHello header;
+    if(!read(&header, sizeof(header)) || header.magic != SOCKET_HELLO_MAGIC || header.version != SOCKET_VERSION){
+        close(descriptor);
+        throw runtime_error("SocketClient.constructor: " + path + " does not speak version " + to_string(SOCKET_VERSION));
+    }
+
+    frequency_list.resize(header.analyzers);
+    if(!read(frequency_list.data(), header.analyzers * sizeof(float))){
+        close(descriptor);
+        throw runtime_error("SocketClient.constructor: " + path + " closed during the greeting");
+    }
+
+    frames_per_batch = header.batch;
+    frame_size = sizeof(SocketFrame) + header.analyzers * sizeof(float);
+    buffer.resize(frames_per_batch * frame_size);
+}
+
+SocketClient::~SocketClient(){
+    close(descriptor);
+}
+
+bool SocketClient::read(void * data, size_t size){
+    uint8_t * cursor = static_cast<uint8_t*>(data);
+    while(size){
+        ssize_t received = recv(descriptor, cursor, size, 0);
+        if(received < 0 && errno == EINTR)
+            continue;
+        if(received <= 0)
+            return false;
+        cursor += received;
+        size -= received;
+    }
+    return true;
+}
+
+bool SocketClient::receive(SocketBatch & header){
+    if(!read(&header, sizeof(header)) || header.magic != SOCKET_BATCH_MAGIC || header.frames > frames_per_batch)
+        return false;
+    //the first batch sets the reference, frames before the connection are not lost
+    if(synchronized && header.sequence > expected)
+        lost += header.sequence - expected;
+    synchronized = true;
+    expected = header.sequence + header.frames;
+    return read(buffer.data(), header.frames * frame_size);
+}
+
+//frames are only 4 byte aligned, a cast would read the timestamp misaligned
+SocketFrame SocketClient::frame(size_t index) const{
+    SocketFrame frame;
+    memcpy(&frame, buffer.data() + index * frame_size, sizeof(frame));
+    return frame;
+}
+
+const float * SocketClient::magnitudes(size_t index) const{
+    return reinterpret_cast<const float*>(buffer.data() + index * frame_size + sizeof(SocketFrame));
+}
+
+size_t SocketClient::analyzers() const{
+    return frequency_list.size();
+}
+
+const vector<float> & SocketClient::frequencies() const{
+    return frequency_list;
+}
+
+size_t SocketClient::batch() const{
+    return frames_per_batch;
+}
+
+uint64_t SocketClient::skipped() const{
+    return lost;
+}
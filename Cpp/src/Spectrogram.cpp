@@ -0,0 +1,59 @@
+#include "Spectrogram.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+Spectrogram::Spectrogram(size_t columns) : columns(columns){}
+
+void Spectrogram::setFrequencies(const vector<float> & frequencies){
+    vector<float> sorted = frequencies;
+    sort(sorted.begin(), sorted.end());
+
+    size_t rows = sorted.size();
+    vector<float> rebuilt(2 * columns * rows, 0.0f);
+
+    //both lists are sorted, walk them together and carry over the rows that survive
+    size_t old = 0;
+    for(size_t row = 0; row < rows; row++){
+        while(old < frequency_list.size() && frequency_list[old] < sorted[row])
+            old++;
+        if(old == frequency_list.size() || frequency_list[old] != sorted[row])
+            continue;
+
+        for(size_t column = 0; column < 2 * columns; column++)
+            rebuilt[column * rows + row] = memory[column * frequency_list.size() + old];
+    }
+
+    frequency_list = std::move(sorted);
+    memory = std::move(rebuilt);
+}
+
+void Spectrogram::push(const float * column){
+    size_t rows = frequency_list.size();
+    copy(column, column + rows, memory.begin() + head * rows);
+    copy(column, column + rows, memory.begin() + (head + columns) * rows);
+    head = head + 1 == columns ? 0 : head + 1;
+}
+
+void Spectrogram::clear(){
+    fill(memory.begin(), memory.end(), 0.0f);
+    head = 0;
+}
+
+size_t Spectrogram::rows() const{
+    return frequency_list.size();
+}
+
+size_t Spectrogram::width() const{
+    return columns;
+}
+
+const vector<float> & Spectrogram::frequencies() const{
+    return frequency_list;
+}
+
+//oldest column first
+const float * Spectrogram::data() const{
+    return memory.data() + head * frequency_list.size();
+}
@@ -0,0 +1,155 @@
+#include "SpectrogramPyramid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+using namespace std;
+
+SpectrogramPyramid::SpectrogramPyramid(size_t columns, size_t levels, size_t budget, const string & path) :
+    capacity(columns),
+    columns(columns),
+    depth(levels),
+    budget(budget),
+    path(path){
+    if(columns < 2 || levels == 0)
+        throw invalid_argument("SpectrogramPyramid.constructor: needs at least two columns and one level");
+}
+
+SpectrogramPyramid::~SpectrogramPyramid(){
+    unmap();
+}
+
+//level 0 has a single channel, the others keep max then mean
+float * SpectrogramPyramid::column(size_t level, bool mean, uint64_t index) const{
+    size_t channel = level == 0 ? 0 : 2 * level - 1 + mean;
+    return memory + (channel * columns + index % columns) * height;
+}
+
+void SpectrogramPyramid::map(){
+    size_t column_bytes = (2 * depth - 1) * max<size_t>(height, 1) * sizeof(float);
+    columns = path.empty() ? clamp<size_t>(budget / column_bytes, 2, capacity) : capacity;
+    length = (2 * depth - 1) * columns * height * sizeof(float);
+    if(length == 0)
+        return;
+
+    void * mapping;
+    if(path.empty())
+        mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    else{
+        int descriptor = open(path.data(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if(descriptor == -1)
+            throw runtime_error("SpectrogramPyramid.map: " + path + ": " + strerror(errno));
+        if(ftruncate(descriptor, length) == -1){
+            int error = errno;
+            close(descriptor);
+            throw runtime_error("SpectrogramPyramid.map: " + path + ": " + strerror(error));
+        }
+        mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        close(descriptor);
+    }
+    if(mapping == MAP_FAILED){
+        length = 0;
+        throw runtime_error("SpectrogramPyramid.map: " + string(strerror(errno)));
+    }
+    memory = static_cast<float*>(mapping);
+}
+
+void SpectrogramPyramid::unmap(){
+    if(memory)
+        munmap(memory, length);
+    memory = nullptr;
+    length = 0;
+}
+
+void SpectrogramPyramid::setRows(size_t rows){
+    unmap();
+    height = rows;
+    total = 0;
+    map();
+}
+
+void SpectrogramPyramid::setPath(const string & path){
+    this->path = path;
+    setRows(height);
+}
+
+void SpectrogramPyramid::push(const float * values){
+    if(!memory)
+        return;
+    copy_n(values, height, column(0, false, total));
+    total++;
+
+    //every second column of a level completes one column of the level above
+    for(size_t k = 1; k < depth && total % (uint64_t(1) << k) == 0; k++){
+        uint64_t index = (total >> k) - 1;
+        const float * max_a = column(k - 1, false, 2 * index);
+        const float * max_b = column(k - 1, false, 2 * index + 1);
+        const float * mean_a = column(k - 1, true, 2 * index);
+        const float * mean_b = column(k - 1, true, 2 * index + 1);
+        float * max_out = column(k, false, index);
+        float * mean_out = column(k, true, index);
+        for(size_t row = 0; row < height; row++){
+            max_out[row] = max(max_a[row], max_b[row]);
+            mean_out[row] = 0.5f * (mean_a[row] + mean_b[row]);
+        }
+    }
+}
+
+void SpectrogramPyramid::clear(){
+    total = 0;
+}
+
+size_t SpectrogramPyramid::rows() const{
+    return height;
+}
+
+size_t SpectrogramPyramid::width() const{
+    return columns;
+}
+
+size_t SpectrogramPyramid::levels() const{
+    return depth;
+}
+
+uint64_t SpectrogramPyramid::frames() const{
+    return total;
+}
+
+//coarsest level that still has a column per pixel, or a coarser one when
+//the finer levels no longer hold the start of the range
+SpectrogramPyramid::Window SpectrogramPyramid::locate(double from, double to, double pixels) const{
+    double now = double(total);
+    double first = max(0.0, floor(from + now));
+    double last = min(now, ceil(to + now));
+
+    size_t level = 0;
+    while(level + 1 < depth && (last - first) / double(uint64_t(1) << (level + 1)) >= pixels)
+        level++;
+    while(level + 1 < depth && (total >> level) > columns && first < double(((total >> level) - columns) << level))
+        level++;
+
+    uint64_t complete = total >> level;
+    uint64_t oldest = complete > columns ? complete - columns : 0;
+    uint64_t begin = max(oldest, uint64_t(first) >> level);
+    uint64_t end = min(complete, (uint64_t(max(last, 0.0)) + (uint64_t(1) << level) - 1) >> level);
+    if(first >= last || begin >= end)
+        return Window{level, 0, 0, 0.0, 0.0};
+
+    return Window{
+        level, begin, size_t(end - begin),
+        double(begin << level) - now,
+        double(end << level) - now
+    };
+}
+
+//columns oldest first, column major
+void SpectrogramPyramid::copy(const Window & window, bool mean, float * destination) const{
+    for(size_t i = 0; i < window.count; i++)
+        copy_n(column(window.level, mean, window.first + i), height, destination + i * height);
+}
@@ -0,0 +1,198 @@
+#include "SpectrogramTexture.hpp"
+
+#include <glad/glad.h>
+#include <cstdio>
+
+static const char * VERTEX_SHADER = R"(#version 130
+out vec2 position;
+void main(){
+    // triangle strip covering the viewport, position is (time, frequency) in [0,1]
+    position = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+static const char * FRAGMENT_SHADER = R"(#version 130
+uniform sampler2D magnitudes;
+uniform sampler2D colormap;
+uniform float offset;
+uniform float minimum;
+uniform float maximum;
+in vec2 position;
+out vec4 color;
+void main(){
+    float magnitude = texture(magnitudes, vec2(position.y, fract(position.x + offset))).r;
+    float level = clamp((magnitude - minimum) / max(maximum - minimum, 1e-12), 0.0, 1.0);
+    color = texture(colormap, vec2(level, 0.5));
+}
+)";
+
+static unsigned int compile(GLenum type, const char * source){
+    unsigned int shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint status;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if(!status){
+        char log[512];
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        fprintf(stderr, "SpectrogramTexture.compile: %s\n", log);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+static void parameters(GLint filter, GLint wrap){
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+}
+
+bool SpectrogramTexture::initialize(){
+    unsigned int vertex = compile(GL_VERTEX_SHADER, VERTEX_SHADER);
+    unsigned int fragment = compile(GL_FRAGMENT_SHADER, FRAGMENT_SHADER);
+    if(!vertex || !fragment){
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+        return false;
+    }
+
+    program = glCreateProgram();
+    glAttachShader(program, vertex);
+    glAttachShader(program, fragment);
+    glBindFragDataLocation(program, 0, "color");
+    glLinkProgram(program);
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+
+    GLint status;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if(!status){
+        char log[512];
+        glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+        fprintf(stderr, "SpectrogramTexture.initialize: %s\n", log);
+        cleanup();
+        return false;
+    }
+
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "magnitudes"), 0);
+    glUniform1i(glGetUniformLocation(program, "colormap"), 1);
+    offset_location = glGetUniformLocation(program, "offset");
+    minimum_location = glGetUniformLocation(program, "minimum");
+    maximum_location = glGetUniformLocation(program, "maximum");
+    glUseProgram(0);
+
+    glGenVertexArrays(1, &vertex_array);
+    glGenFramebuffers(1, &framebuffer);
+    glGenTextures(1, &magnitudes);
+    glGenTextures(1, &colormap);
+    glGenTextures(1, &image);
+
+    //grayscale until a colormap is set
+    uint32_t gray[2] = {0xff000000, 0xffffffff};
+    setColormap(gray, 2);
+    return true;
+}
+
+void SpectrogramTexture::cleanup(){
+    glDeleteProgram(program);
+    glDeleteVertexArrays(1, &vertex_array);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteTextures(1, &magnitudes);
+    glDeleteTextures(1, &colormap);
+    glDeleteTextures(1, &image);
+    program = vertex_array = framebuffer = magnitudes = colormap = image = 0;
+    rows = columns = 0;
+}
+
+bool SpectrogramTexture::valid() const{
+    return program != 0;
+}
+
+// colors as ImU32 (0xAABBGGRR), sampled linearly by the shader
+void SpectrogramTexture::setColormap(const uint32_t * colors, size_t count){
+    glBindTexture(GL_TEXTURE_2D, colormap);
+    parameters(GL_LINEAR, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, count, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, colors);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    dirty = true;
+}
+
+// data is column major, oldest column first: columns * rows floats
+void SpectrogramTexture::resize(size_t rows, size_t columns, const float * data){
+    this->rows = rows;
+    this->columns = columns;
+    head = 0;
+    dirty = true;
+    if(rows == 0 || columns == 0)
+        return;
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, magnitudes);
+    parameters(GL_NEAREST, GL_REPEAT);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, rows, columns, 0, GL_RED, GL_FLOAT, data);
+
+    glBindTexture(GL_TEXTURE_2D, image);
+    parameters(GL_NEAREST, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, columns, rows, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, image, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void SpectrogramTexture::push(const float * column){
+    if(rows == 0 || columns == 0)
+        return;
+
+    glBindTexture(GL_TEXTURE_2D, magnitudes);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, head, rows, 1, GL_RED, GL_FLOAT, column);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    head = head + 1 == columns ? 0 : head + 1;
+    dirty = true;
+}
+
+// Redraws the image only when something changed, returns it as an ImTextureID
+uint64_t SpectrogramTexture::render(float minimum, float maximum){
+    if(rows == 0 || columns == 0)
+        return 0;
+
+    if(dirty || minimum != this->minimum || maximum != this->maximum){
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glViewport(0, 0, columns, rows);
+        glDisable(GL_BLEND);
+        glDisable(GL_SCISSOR_TEST);
+
+        glUseProgram(program);
+        glUniform1f(offset_location, (float)head / columns);
+        glUniform1f(minimum_location, minimum);
+        glUniform1f(maximum_location, maximum);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, colormap);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, magnitudes);
+
+        glBindVertexArray(vertex_array);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        glBindVertexArray(0);
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glUseProgram(0);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+        this->minimum = minimum;
+        this->maximum = maximum;
+        dirty = false;
+    }
+
+    return image;
+}
@@ -0,0 +1,99 @@
+#include "SpectrumBank.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+//the engines that were not running hold nothing or older magnitudes, a switch makes the bank stale
+void SpectrumBank::choose(){
+    Engine previous = active;
+    active = pick();
+    if(active != previous)
+        stale = true;
+}
+
+SpectrumBank::Engine SpectrumBank::pick() const{
+    if(degraded && requested != MULTIRATE)
+        return FFT;
+    if(requested != AUTO)
+        return requested;
+
+    const vector<float> & list = goertzel.frequencies();
+    if(list.size() < CROSSOVER)
+        return GOERTZEL;
+
+    vector<float> gaps(list.size() - 1);
+    for(size_t i = 0; i + 1 < list.size(); i++)
+        gaps[i] = list[i + 1] - list[i];
+    nth_element(gaps.begin(), gaps.begin() + gaps.size() / 2, gaps.end());
+    return gaps[gaps.size() / 2] >= FFTBank::resolution(BUFFER_SIZE) ? FFT : GOERTZEL;
+}
+
+//every engine holds every analyzer, a switch costs nothing at execute time
+void SpectrumBank::add(const vector<float> & frequencies){
+    goertzel.add(frequencies);
+    fft.add(frequencies);
+    multirate.add(frequencies);
+    stale = true;
+    choose();
+}
+
+void SpectrumBank::remove(const vector<float> & frequencies){
+    goertzel.remove(frequencies);
+    fft.remove(frequencies);
+    multirate.remove(frequencies);
+    stale = true;
+    choose();
+}
+
+void SpectrumBank::clear(){
+    goertzel.clear();
+    fft.clear();
+    multirate.clear();
+    stale = true;
+    choose();
+}
+
+size_t SpectrumBank::find(float frequency) const{
+    return goertzel.find(frequency);
+}
+
+size_t SpectrumBank::size() const{
+    return goertzel.size();
+}
+
+const vector<float> & SpectrumBank::frequencies() const{
+    return goertzel.frequencies();
+}
+
+float SpectrumBank::magnitude(size_t index) const{
+    if(active == FFT)
+        return fft.magnitude(index);
+    if(active == MULTIRATE)
+        return multirate.magnitude(index);
+    return goertzel.magnitude(index);
+}
+
+void SpectrumBank::setEngine(Engine engine){
+    requested = engine;
+    choose();
+}
+
+void SpectrumBank::setDegraded(bool degraded){
+    if(this->degraded == degraded)
+        return;
+    this->degraded = degraded;
+    choose();
+}
+
+void SpectrumBank::setExtended(bool extended){
+    multirate.setExtended(extended);
+}
+
+SpectrumBank::Engine SpectrumBank::engine() const{
+    return active;
+}
+
+bool SpectrumBank::isStale() const{
+    return stale;
+}
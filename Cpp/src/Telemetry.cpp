@@ -0,0 +1,73 @@
+#include "Telemetry.hpp"
+
+#include <time.h>
+
+Histogram Telemetry::histograms[METRICS];
+
+static const char * NAMES[Telemetry::METRICS] = {
+    "read",
+    "copy",
+    "source latency",
+    "analyzer banks",
+    "chirp-z bands",
+    "harmonics",
+    "wbas.execute",
+    "publish",
+    "analysis cpu",
+    "publish to draw",
+    "audio to pixel",
+    "render cpu"
+};
+
+Telemetry::Scope::Scope(Metric metric) : metric(metric), start(now()){}
+
+Telemetry::Scope::~Scope(){
+    record(metric, now() - start);
+}
+
+uint64_t Telemetry::now(){
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return uint64_t(time.tv_sec) * 1000000000ull + time.tv_nsec;
+}
+
+uint64_t Telemetry::threadTime(){
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return uint64_t(time.tv_sec) * 1000000000ull + time.tv_nsec;
+}
+
+void Telemetry::record(Metric metric, uint64_t value){
+    histograms[metric].record(value);
+}
+
+const Histogram & Telemetry::histogram(Metric metric){
+    return histograms[metric];
+}
+
+const char * Telemetry::name(Metric metric){
+    return NAMES[metric];
+}
+
+void Telemetry::clear(){
+    for(Histogram & histogram : histograms)
+        histogram.clear();
+}
+
+//one line per metric, values in microseconds
+void Telemetry::print(FILE * file, const char * prefix){
+    fprintf(file, "%s%-16s %10s %10s %10s %10s %10s\n", prefix, "stage", "count", "p50_us", "p99_us", "p99.9_us", "max_us");
+    for(size_t metric = 0; metric < METRICS; metric++){
+        const Histogram & histogram = histograms[metric];
+        fprintf(file, "%s%-16s %10llu %10.1f %10.1f %10.1f %10.1f\n",
+            prefix,
+            NAMES[metric],
+            (unsigned long long)histogram.samples(),
+            histogram.percentile(0.5) * 1e-3,
+            histogram.percentile(0.99) * 1e-3,
+            histogram.percentile(0.999) * 1e-3,
+            histogram.maximum() * 1e-3
+        );
+    }
+    fflush(file);
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "Trace.hpp"
+
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+std::atomic<bool> Trace::on = false;
+
+namespace{
+    // written by its thread only, event i at i % CAPACITY; count is published
+    // after the event and also tells readers which slots may be under rewrite
+    struct Buffer{
+        Trace::Event events[Trace::CAPACITY];
+        std::atomic<size_t> count = 0;
+        std::atomic<const char *> name = nullptr;
+        pid_t tid;
+    };
+
+    // buffers outlive their threads so write() still sees them
+    std::mutex buffers_lock;
+    std::vector<std::unique_ptr<Buffer>> buffers;
+    thread_local Buffer * local = nullptr;
+
+    // ticks() and CLOCK_MONOTONIC at load, paired with a later reading for the tick rate
+    struct Anchor{
+        uint64_t ticks;
+        uint64_t ns;
+    };
+    Anchor anchor(){
+        timespec time;
+        uint64_t ticks = Trace::ticks();
+        clock_gettime(CLOCK_MONOTONIC, &time);
+        return {ticks, uint64_t(time.tv_sec) * 1000000000ull + time.tv_nsec};
+    }
+
+    const Anchor origin = anchor();
+
+    Buffer * buffer(){
+        if(!local){
+            auto created = std::make_unique<Buffer>();
+            created->tid = syscall(SYS_gettid);
+            std::lock_guard lock(buffers_lock);
+            local = created.get();
+            buffers.push_back(std::move(created));
+        }
+        return local;
+    }
+}
+
+uint64_t Trace::now(){
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return uint64_t(time.tv_sec) * 1000000000ull + time.tv_nsec;
+}
+
+void Trace::enable(bool on){
+    Trace::on.store(on, std::memory_order_relaxed);
+}
+
+void Trace::thread(const char * name){
+    buffer()->name.store(name, std::memory_order_relaxed);
+}
+
+void Trace::record(const char * name, uint64_t start, uint64_t duration){
+    Buffer * buffer = ::buffer();
+    size_t count = buffer->count.load(std::memory_order_relaxed);
+    //the previous count must be visible before the oldest slot changes
+    std::atomic_thread_fence(std::memory_order_release);
+    buffer->events[count % CAPACITY] = {name, start, duration};
+    buffer->count.store(count + 1, std::memory_order_release);
+}
+
+size_t Trace::events(){
+    std::lock_guard lock(buffers_lock);
+    size_t events = 0;
+    for(const auto & buffer : buffers)
+        events += std::min(buffer->count.load(std::memory_order_acquire), CAPACITY);
+    return events;
+}
+
+size_t Trace::dropped(){
+    std::lock_guard lock(buffers_lock);
+    size_t dropped = 0;
+    for(const auto & buffer : buffers){
+        size_t count = buffer->count.load(std::memory_order_relaxed);
+        dropped += count > CAPACITY ? count - CAPACITY : 0;
+    }
+    return dropped;
+}
+
+//trace-event JSON, timestamps in microseconds
+void Trace::write(FILE * file){
+    Anchor current = anchor();
+    if(current.ns - origin.ns < 10000000){
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        current = anchor();
+    }
+    double ns_per_tick = double(current.ns - origin.ns) / double(current.ticks - origin.ticks);
+
+    std::lock_guard lock(buffers_lock);
+    pid_t pid = getpid();
+
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    bool first = true;
+    for(const auto & buffer : buffers){
+        const char * name = buffer->name.load(std::memory_order_relaxed);
+        if(name){
+            fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",\n", pid, buffer->tid, name);
+            first = false;
+        }
+
+        //copy first: a thread still recording may overwrite the oldest slots meanwhile,
+        //anything at or below the count seen afterwards minus CAPACITY is suspect
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        size_t oldest = count > CAPACITY ? count - CAPACITY : 0;
+        std::vector<Event> events(count - oldest);
+        for(size_t i = oldest; i < count; i++)
+            events[i - oldest] = buffer->events[i % CAPACITY];
+        std::atomic_thread_fence(std::memory_order_acquire);
+        size_t after = buffer->count.load(std::memory_order_relaxed);
+        size_t valid = after >= CAPACITY ? after - CAPACITY + 1 : 0;
+
+        for(size_t i = std::max(oldest, valid); i < count; i++){
+            const Event & event = events[i - oldest];
+            fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d}",
+                first ? "" : ",\n", event.name,
+                (origin.ns + (double(event.start) - double(origin.ticks)) * ns_per_tick) * 1e-3,
+                event.duration * ns_per_tick * 1e-3, pid, buffer->tid);
+            first = false;
+        }
+    }
+    fprintf(file, "\n]}\n");
+    fflush(file);
+}
+
+bool Trace::write(const std::string & path){
+    FILE * file = fopen(path.data(), "w");
+    if(!file)
+        return false;
+    write(file);
+    return fclose(file) == 0;
+}
@@ -0,0 +1,34 @@
+template<typename F>
+void ArchiveReader::query(size_t column, uint64_t begin, uint64_t end, F callback) const{
+    if(column >= header.columns || begin >= end)
+        return;
+
+    //first block that is not entirely before the range
+    size_t low = 0;
+    size_t high = count;
+    while(low < high){
+        size_t middle = (low + high) / 2;
+        if(entries[middle].last_time < begin)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    for(size_t i = low; i < count && entries[i].first_time < end; i++){
+        const uint8_t * current = block(i);
+        const ArchiveBlock * description = reinterpret_cast<const ArchiveBlock*>(current);
+        const float * minimum = reinterpret_cast<const float*>(current + sizeof(ArchiveBlock));
+        const float * scale = minimum + header.columns;
+        const uint32_t * time = reinterpret_cast<const uint32_t*>(scale + header.columns);
+        const uint16_t * values = reinterpret_cast<const uint16_t*>(time + header.rows) + column * header.rows;
+
+        for(size_t row = 0; row < description->rows; row++){
+            uint64_t timestamp = description->first_time + time[row] * 1000ull;
+            if(timestamp < begin)
+                continue;
+            if(timestamp >= end)
+                return;
+            callback(timestamp, minimum[column] + values[row] * scale[column]);
+        }
+    }
+}
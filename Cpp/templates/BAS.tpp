@@ -17,7 +17,7 @@ float BAS::nthArea(const std::array<float,N> & samples, float alpha, float beta)
 
 template<size_t N>
 float BAS::execute(const std::array<float,N>& samples){
-    
+    TRACE_SCOPE("BAS::execute");
     std::array<float,N> y;
     for(float i = 1; i <= samples.size(); i++)
         y[i-1] = - samples[i-1] / i;                           //don´t forget the j implications
@@ -0,0 +1,27 @@
+template<size_t N>
+void ChirpZ::execute(const std::array<float,N> & samples){
+    if(frame != N)
+        prepare(N);
+
+    size_t length = fft.size();
+    for(size_t n = 0; n < N; n++){
+        buffer_re[n] = samples[n] * chirp_re[n];
+        buffer_im[n] = samples[n] * chirp_im[n];
+    }
+    std::fill(buffer_re.begin() + N, buffer_re.end(), 0.0f);
+    std::fill(buffer_im.begin() + N, buffer_im.end(), 0.0f);
+
+    fft.forward(buffer_re.data(), buffer_im.data());
+    for(size_t k = 0; k < length; k++){
+        float re = buffer_re[k] * kernel_re[k] - buffer_im[k] * kernel_im[k];
+        float im = buffer_re[k] * kernel_im[k] + buffer_im[k] * kernel_re[k];
+        buffer_re[k] = re;
+        buffer_im[k] = im;
+    }
+    fft.inverse(buffer_re.data(), buffer_im.data());
+
+    //the output chirp only turns the phase, the magnitude does not need it
+    float scale = 1.0f / (float(length) * float(length));
+    for(size_t m = 0; m < count; m++)
+        results[m] = (buffer_re[m] * buffer_re[m] + buffer_im[m] * buffer_im[m]) * scale;
+}
@@ -0,0 +1,20 @@
+template<size_t N>
+void FFTBank::execute(const std::array<float,N> & samples){
+    if(fft.size() != OVERSAMPLING * N)
+        place(N);
+    fft.forward(samples.data(), N);
+
+    const float * spectrum_re = fft.re();
+    const float * spectrum_im = fft.im();
+    for(size_t i = 0; i < frequency_list.size(); i++){
+        const Tap * tap = taps.data() + i * TAPS;
+        const float * x_re = spectrum_re + first[i];
+        const float * x_im = spectrum_im + first[i];
+        float y_re = 0, y_im = 0;
+        for(size_t t = 0; t < TAPS; t++){
+            y_re += tap[t].re_re * x_re[t] + tap[t].re_im * x_im[t];
+            y_im += tap[t].im_re * x_re[t] + tap[t].im_im * x_im[t];
+        }
+        results[i] = y_re * y_re + y_im * y_im;
+    }
+}
@@ -0,0 +1,24 @@
+template<typename datatype>
+FrameAllocator<datatype>::FrameAllocator(FrameArena & arena) noexcept : arena(&arena){}
+
+template<typename datatype>
+template<typename other>
+FrameAllocator<datatype>::FrameAllocator(const FrameAllocator<other> & allocator) noexcept : arena(allocator.arena){}
+
+template<typename datatype>
+inline datatype * FrameAllocator<datatype>::allocate(size_t count){
+    return static_cast<datatype*>(arena->allocate(count * sizeof(datatype), alignof(datatype)));
+}
+
+template<typename datatype>
+inline void FrameAllocator<datatype>::deallocate(datatype *, size_t) noexcept{}
+
+template<typename first, typename second>
+inline bool operator==(const FrameAllocator<first> & a, const FrameAllocator<second> & b){
+    return a.arena == b.arena;
+}
+
+template<typename first, typename second>
+inline bool operator!=(const FrameAllocator<first> & a, const FrameAllocator<second> & b){
+    return a.arena != b.arena;
+}
@@ -0,0 +1,29 @@
+template<size_t N, size_t WIDTH>
+void GoertzelBank::execute(const std::array<float,N> & samples){
+    execute<WIDTH>(samples.data(), N);
+}
+
+template<size_t WIDTH>
+void GoertzelBank::execute(const float * samples, size_t count){
+    static_assert(PADDING % WIDTH == 0, "GoertzelBank.execute: WIDTH must divide PADDING");
+    for(size_t base = 0; base < iir_1.size(); base += WIDTH){
+        float s_1[WIDTH] = {};
+        float s_2[WIDTH] = {};
+        const float * coefficients = iir_1.data() + base;
+
+        for(size_t n = 0; n < count; n++){
+            float sample = samples[n];
+            for(size_t lane = 0; lane < WIDTH; lane++){
+                float s_0 = sample + coefficients[lane] * s_1[lane] - s_2[lane];
+                s_2[lane] = s_1[lane];
+                s_1[lane] = s_0;
+            }
+        }
+
+        for(size_t lane = 0; lane < WIDTH; lane++){
+            float re = s_1[lane] - fir_1[base + lane] * s_2[lane];
+            float im = fir_2[base + lane] * s_2[lane];
+            results[base + lane] = re * re + im * im;
+        }
+    }
+}
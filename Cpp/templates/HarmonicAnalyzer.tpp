@@ -0,0 +1,33 @@
+template<size_t N, size_t WIDTH>
+void HarmonicAnalyzer::sweep(const std::array<float,N> & samples){
+    float s_1[WIDTH] = {};
+    float s_2[WIDTH] = {};
+    const float * coefficients = iir_1.data();
+
+    for(float sample : samples){
+        for(size_t lane = 0; lane < WIDTH; lane++){
+            float s_0 = sample + coefficients[lane] * s_1[lane] - s_2[lane];
+            s_2[lane] = s_1[lane];
+            s_1[lane] = s_0;
+        }
+    }
+
+    for(size_t lane = 0; lane < active; lane++){
+        float re = s_1[lane] - fir_1[lane] * s_2[lane];
+        float im = fir_2[lane] * s_2[lane];
+        results[lane] = re * re + im * im;
+    }
+}
+
+//the sweep is as wide as the harmonics in use, rounded up to LANES
+template<size_t N>
+void HarmonicAnalyzer::execute(const std::array<float,N> & samples){
+    static_assert(MAX_HARMONICS == 4 * LANES, "HarmonicAnalyzer.execute: one case per multiple of LANES");
+    switch((active + LANES - 1) / LANES){
+        case 0: break;
+        case 1: sweep<N,LANES>(samples); break;
+        case 2: sweep<N,2 * LANES>(samples); break;
+        case 3: sweep<N,3 * LANES>(samples); break;
+        default: sweep<N,4 * LANES>(samples); break;
+    }
+}
@@ -0,0 +1,13 @@
+inline size_t Histogram::bucket(uint64_t value){
+    if(value < SUB_BUCKETS)
+        return value;
+    size_t shift = 63 - __builtin_clzll(value) - SUB_BITS;
+    return ((shift + 1) << SUB_BITS) + (value >> shift) - SUB_BUCKETS;
+}
+
+inline void Histogram::record(uint64_t value){
+    counts[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t current = largest.load(std::memory_order_relaxed);
+    while(value > current && !largest.compare_exchange_weak(current, value, std::memory_order_relaxed));
+}
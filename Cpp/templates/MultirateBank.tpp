@@ -0,0 +1,32 @@
+template<size_t N>
+void MultirateBank::execute(const std::array<float,N> & samples){
+    static_assert(N % (size_t(1) << LEVELS) == 0, "MultirateBank.execute: N must be a multiple of 2^LEVELS");
+    if(frame != N)
+        prepare(N);
+
+    if(levels[0].bank.size())
+        levels[0].bank.execute(samples);
+
+    const float * source = samples.data();
+    size_t count = N;
+    for(size_t l = 1; l <= depth; l++){
+        Level & level = levels[l];
+        decimate(level, source, count);
+        count /= 2;
+        source = level.output.data();
+
+        //the window slides by this frame's samples
+        size_t fresh = std::min(count, level.window.size());
+        std::copy(level.window.begin() + fresh, level.window.end(), level.window.begin());
+        std::copy(level.output.begin() + count - fresh, level.output.begin() + count, level.window.end() - fresh);
+        if(level.bank.size())
+            level.bank.execute(level.window.data(), level.window.size());
+    }
+
+    for(size_t l = 0; l <= depth; l++){
+        const Level & level = levels[l];
+        float scale = l ? float(N) / level.window.size() : 1.0f;
+        for(size_t i = 0; i < level.analyzers.size(); i++)
+            results[level.analyzers[i]] = level.bank.magnitude(i) * scale * scale;
+    }
+}
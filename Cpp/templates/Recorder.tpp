@@ -73,13 +73,17 @@ inline float Recorder<N>::record(){
 
 template<size_t N>
 inline void Recorder<N>::record(std::array<float,N> & frame){
-    
-    std::copy(
-        this->frame.begin(),
-        this->frame.end(),
-        frame.begin()
-    );
+    TRACE_SCOPE("Recorder::record");
+    {
+        Telemetry::Scope scope(Telemetry::COPY);
+        std::copy(
+            this->frame.begin(),
+            this->frame.end(),
+            frame.begin()
+        );
+    }
 
+    Telemetry::Scope scope(Telemetry::READ);
     pa_simple_read(
         pulse_audio_handle,
         this->frame.data(),
@@ -88,4 +92,12 @@ inline void Recorder<N>::record(std::array<float,N> & frame){
     );
 
     index = 0;
+}
+
+//ns the newest captured audio waited in the source, 0 when unknown
+template<size_t N>
+uint64_t Recorder<N>::latency(){
+    int error;
+    pa_usec_t latency = pa_simple_get_latency(pulse_audio_handle, &error);
+    return latency == (pa_usec_t)-1 ? 0 : latency * 1000;
 }
\ No newline at end of file
@@ -0,0 +1,17 @@
+template<typename F>
+size_t Scheduler::drain(F callback){
+    size_t pending;
+    {
+        //swapping keeps every buffer's capacity, nothing is copied or allocated
+        std::lock_guard<std::mutex> guard(lock);
+        pending = count;
+        for(size_t i = 0; i < pending; i++)
+            std::swap(consumed[i], queue[(head + i) % QUEUE]);
+        head = (head + pending) % QUEUE;
+        count = 0;
+    }
+
+    for(size_t i = 0; i < pending; i++)
+        callback(consumed[i]);
+    return pending;
+}
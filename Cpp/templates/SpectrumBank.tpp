@@ -0,0 +1,10 @@
+template<size_t N>
+void SpectrumBank::execute(const std::array<float,N> & samples){
+    if(active == FFT)
+        fft.execute(samples);
+    else if(active == MULTIRATE)
+        multirate.execute(samples);
+    else
+        goertzel.execute(samples);
+    stale = false;
+}
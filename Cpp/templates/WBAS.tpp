@@ -10,6 +10,7 @@ float WBAS<N>::energy(const std::array<float,N>& samples, size_t step){
 
 template<size_t N>
 void WBAS<N>::filter(const std::array<float,N>& samples, std::array<float,N>& filtered, size_t step){
+    PerfCounters::Scope counters(PerfCounters::SOS, N / step);
     for(size_t i = 0; i < samples.size(); i += step)
         filtered[i] = lpf.execute(samples[i]);
     lpf.clear();
@@ -21,6 +22,7 @@ void WBAS<N>::upperband(const std::array<float,N>& wholeband, const std::array<f
     
     //there are way more efficient ways of doing this... (time varing filter coefficients)
     size_t j = 0;
+    PerfCounters::Scope counters(PerfCounters::SOS, N);
     for(size_t i = 0; i < N; i++)
         upperband[i] = lpf.execute(COS_PI2[i&0b11] * (wholeband[i] - lowerband[i]));
     lpf.clear();    
@@ -28,7 +30,7 @@ void WBAS<N>::upperband(const std::array<float,N>& wholeband, const std::array<f
 
 template<size_t N>
 float WBAS<N>::execute(const std::array<float,N>& samples){
-    
+    TRACE_SCOPE("WBAS::execute");
     float low = 0;
     float up = SAMPLE_RATE/2.0f;
     std::array<float,N> auxiliars[2];
@@ -39,8 +41,8 @@ float WBAS<N>::execute(const std::array<float,N>& samples){
     std::copy(samples.begin(),samples.end(),(*whole).begin());
     
     float wb_energy = energy(samples,1);
-    std::cout << "start" << std::endl;
-    for(size_t i = 1; i < samples.size(); i <<= 1){
+    size_t level = 0;
+    for(size_t i = 1; i < samples.size() && (depth == 0 || level < depth); i <<= 1, level++){
         
         filter(*whole,*lower,i);
         float lb_energy = energy(*lower,i);
@@ -50,15 +52,18 @@ float WBAS<N>::execute(const std::array<float,N>& samples){
             wb_energy = lb_energy/2;//estimate
             std::swap(lower,whole);
             up -= (up - low)/2.0f;
-            std::cout << "\tup" << std::endl;
         }
         else{//upper band wins
             wb_energy = ub_energy/2;//estimate
             upperband(*whole, *lower, *whole, i);
             low += (up - low)/2.0f;
-            std::cout << "\tlow" << std::endl;
         }
     }
 
     return (low + up)/2.0f;
+}
+
+template<size_t N>
+void WBAS<N>::set(size_t depth){
+    this->depth = depth;
 }
\ No newline at end of file
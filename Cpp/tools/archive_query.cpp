@@ -0,0 +1,54 @@
+#include "Archive.hpp"
+
+#include <ctime>
+#include <cstdio>
+#include <string>
+#include <cstdlib>
+#include <stdexcept>
+
+using namespace std;
+
+// Seconds since epoch or local time as YYYY-MM-DDTHH:MM[:SS]
+static uint64_t parse(const string & text){
+    tm broken = {};
+    const char * rest = strptime(text.data(), "%Y-%m-%dT%H:%M", &broken);
+    if(rest){
+        if(*rest == ':')
+            rest = strptime(rest, ":%S", &broken);
+        if(!rest || *rest)
+            throw invalid_argument("archive_query: bad time " + text);
+        broken.tm_isdst = -1;
+        return mktime(&broken) * 1000000000ull;
+    }
+    return stoull(text) * 1000000000ull;
+}
+
+int main(int argc, char ** argv){
+    if(argc != 5){
+        fprintf(stderr,
+            "usage: %s <archive> <frequency> <begin> <end>\n"
+            "    times are seconds since epoch or local YYYY-MM-DDTHH:MM[:SS]\n",
+            argv[0]
+        );
+        return 1;
+    }
+
+    try{
+        ArchiveReader reader(argv[1]);
+        size_t column = reader.column(stof(argv[2]));
+        uint64_t begin = parse(argv[3]);
+        uint64_t end = parse(argv[4]);
+
+        printf("# time magnitude@%.2f\n", reader.frequencies()[column]);
+        size_t rows = 0;
+        reader.query(column, begin, end, [&](uint64_t timestamp, float magnitude){
+            printf("%llu %.6f\n", (unsigned long long)timestamp, magnitude);
+            rows++;
+        });
+        fprintf(stderr, "%zu rows out of %zu blocks\n", rows, reader.blocks());
+    }
+    catch(const exception& e){
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,333 @@
+#include "Goertzel.hpp"
+#include "GoertzelBank.hpp"
+#include "FFTBank.hpp"
+#include "MultirateBank.hpp"
+#include "HarmonicAnalyzer.hpp"
+#include "Filter.hpp"
+#include "WBAS.hpp"
+#include "BAS.hpp"
+#include "PerfCounters.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <sched.h>
+
+using namespace std;
+using clock_t_ = chrono::steady_clock;
+
+// Microbenchmarks of the DSP kernels. Every case is warmed up, calibrated so
+// one repeat lasts about `seconds`, then repeated; the median and the best
+// repeat are reported in ns per input sample. Where perf events are allowed,
+// one more untimed repeat reads the hardware counters for IPC and misses per
+// sample. Results go to stdout as JSON, progress to stderr.
+//     bas-bench [cpu (-1: no pinning)] [repeats] [seconds per repeat] [kernel filter]
+
+struct Options{
+    int cpu = 0;
+    size_t repeats = 7;
+    double seconds = 0.05;
+    string filter;
+};
+
+struct Result{
+    string kernel;
+    size_t frame;
+    size_t analyzers;
+    size_t lanes;
+    size_t iterations;
+    double median;
+    double best;
+    bool counted;
+    double counters[PerfCounters::COUNTERS];   // per input sample
+};
+
+static Options options;
+static bool counters;
+static size_t fft_crossover;
+static vector<Result> results;
+static volatile float sink;
+
+//one call of `body` processes `frame` input samples
+template<typename F>
+static void measure(const string & kernel, size_t frame, size_t analyzers, size_t lanes, F body){
+    if(!options.filter.empty() && kernel.find(options.filter) == string::npos)
+        return;
+
+    //warm up caches and frequency scaling, then size a repeat
+    size_t iterations = 1;
+    while(true){
+        auto start = clock_t_::now();
+        for(size_t i = 0; i < iterations; i++)
+            body();
+        double elapsed = chrono::duration<double>(clock_t_::now() - start).count();
+        if(elapsed >= options.seconds / 4){
+            iterations = max<size_t>(1, iterations * options.seconds / elapsed);
+            break;
+        }
+        iterations *= 2;
+    }
+
+    vector<double> repeats;
+    for(size_t r = 0; r < options.repeats; r++){
+        auto start = clock_t_::now();
+        for(size_t i = 0; i < iterations; i++)
+            body();
+        double elapsed = chrono::duration<double, nano>(clock_t_::now() - start).count();
+        repeats.push_back(elapsed / (double(iterations) * frame));
+    }
+    sort(repeats.begin(), repeats.end());
+
+    Result result = {kernel, frame, analyzers, lanes, iterations, repeats[repeats.size() / 2], repeats.front(), false, {}};
+
+    //separate repeat, the reads stay out of the timings
+    PerfCounters::Reading before, after;
+    if(counters && PerfCounters::read(before)){
+        for(size_t i = 0; i < iterations; i++)
+            body();
+        if(PerfCounters::read(after)){
+            result.counted = true;
+            for(size_t i = 0; i < PerfCounters::COUNTERS; i++)
+                result.counters[i] = double(after.values[i] - before.values[i]) / (double(iterations) * frame);
+        }
+    }
+
+    results.push_back(result);
+    fprintf(stderr, "%-10s frame %5zu analyzers %5zu lanes %2zu: %10.3f ns/sample", kernel.data(), frame, analyzers, lanes, result.median);
+    if(result.counted)
+        fprintf(stderr, " ipc %5.2f", result.counters[PerfCounters::INSTRUCTIONS] / result.counters[PerfCounters::CYCLES]);
+    fprintf(stderr, "\n");
+}
+
+template<size_t N, size_t WIDTH>
+static void bank(const array<float,N> & samples, size_t analyzers){
+    GoertzelBank bank;
+    vector<float> frequencies(analyzers);
+    for(size_t i = 0; i < analyzers; i++)
+        frequencies[i] = 20.0f + i * (20000.0f / analyzers);
+    bank.add(frequencies);
+
+    measure("bank", N, analyzers, WIDTH, [&](){
+        bank.execute<N,WIDTH>(samples);
+        sink = bank.magnitude(0);
+    });
+}
+
+template<size_t N>
+static void fftBank(const array<float,N> & samples, size_t analyzers){
+    FFTBank bank;
+    vector<float> frequencies(analyzers);
+    for(size_t i = 0; i < analyzers; i++)
+        frequencies[i] = 20.0f + i * (20000.0f / analyzers);
+    bank.add(frequencies);
+
+    measure("fftbank", N, analyzers, 1, [&](){
+        bank.execute(samples);
+        sink = bank.magnitude(0);
+    });
+}
+
+//low frequency analyzers (20-280 Hz) on the full rate bank and on the decimated levels
+template<size_t N>
+static void multirate(const array<float,N> & samples, size_t analyzers){
+    vector<float> frequencies(analyzers);
+    for(size_t i = 0; i < analyzers; i++)
+        frequencies[i] = 20.0f + i * (260.0f / analyzers);
+
+    GoertzelBank bank;
+    bank.add(frequencies);
+    measure("lowbank", N, analyzers, GoertzelBank::LANES, [&](){
+        bank.execute(samples);
+        sink = bank.magnitude(0);
+    });
+
+    MultirateBank multirate;
+    multirate.add(frequencies);
+    measure("multirate", N, analyzers, GoertzelBank::LANES, [&](){
+        multirate.execute(samples);
+        sink = multirate.magnitude(0);
+    });
+}
+
+//fundamental and 20 harmonics: one fused sweep, the same frequencies on the bank, and the retune alone
+template<size_t N>
+static void harmonics(const array<float,N> & samples){
+    const size_t count = 20;
+    HarmonicAnalyzer analyzer(437.0f, count);
+    measure("harmonics", N, count, HarmonicAnalyzer::LANES, [&](){
+        analyzer.execute(samples);
+        sink = analyzer.thd();
+    });
+
+    GoertzelBank bank;
+    vector<float> frequencies(count);
+    for(size_t k = 0; k < count; k++)
+        frequencies[k] = 437.0f * (k + 1);
+    bank.add(frequencies);
+    measure("harmbank", N, count, GoertzelBank::LANES, [&](){
+        bank.execute(samples);
+        sink = bank.magnitude(0);
+    });
+
+    float fundamental = 437.0f;
+    measure("retune", N, count, 1, [&](){
+        fundamental = fundamental < 500.0f ? fundamental + 0.01f : 437.0f;
+        analyzer.retune(fundamental);
+        sink = fundamental;
+    });
+}
+
+//smallest analyzer count where the FFT bank beats the Goertzel bank, 0 if none measured
+template<size_t N>
+static size_t crossover(const array<float,N> & samples){
+    for(size_t analyzers = 16; analyzers <= 4096; analyzers *= 2)
+        if(analyzers != 16 && analyzers != 256 && analyzers != 2048){
+            bank<N,GoertzelBank::LANES>(samples, analyzers);
+            fftBank<N>(samples, analyzers);
+        }
+
+    for(size_t analyzers = 16; analyzers <= 4096; analyzers *= 2){
+        double goertzel = 0, fft = 0;
+        for(const Result & result : results)
+            if(result.frame == N && result.analyzers == analyzers){
+                if(result.kernel == "bank" && result.lanes == GoertzelBank::LANES)
+                    goertzel = result.median;
+                if(result.kernel == "fftbank")
+                    fft = result.median;
+            }
+        if(goertzel > 0 && fft > 0 && fft < goertzel)
+            return analyzers;
+    }
+    return 0;
+}
+
+template<size_t N>
+static void frameSize(){
+    //deterministic input: a tone in white noise
+    array<float,N> samples;
+    mt19937 generator(1);
+    normal_distribution<float> noise(0.0f, 0.1f);
+    for(size_t i = 0; i < N; i++)
+        samples[i] = 0.5f * sin(2.0f * M_PI * 1000.0f * i / SAMPLE_RATE) + noise(generator);
+
+    Goertzel goertzel(1000.0f);
+    measure("goertzel", N, 1, 1, [&](){
+        sink = goertzel.execute(samples);
+    });
+
+    for(size_t analyzers : {16, 256, 2048}){
+        bank<N,1>(samples, analyzers);
+        bank<N,4>(samples, analyzers);
+        bank<N,8>(samples, analyzers);
+        bank<N,16>(samples, analyzers);
+        fftBank<N>(samples, analyzers);
+        multirate<N>(samples, analyzers);
+    }
+
+    harmonics<N>(samples);
+
+    RealFFT fft(FFTBank::OVERSAMPLING * N);
+    measure("fft", N, 1, 1, [&](){
+        fft.forward(samples.data(), N);
+        sink = fft.re(1);
+    });
+
+    BAS bas(0, 8e3, 10, 1, 100);
+    measure("bas", N, 1, 1, [&](){
+        sink = bas.execute(samples);
+    });
+
+    static WBAS<N> wbas;
+    measure("wbas", N, 1, 1, [&](){
+        sink = wbas.execute(samples);
+    });
+
+    //same coefficients as the WBAS low pass
+    Sos<2,float,float,float> sos({{
+        {{{0.120960f, -0.019523f, 0.120960f}}, {{-1.152464f, 0.462928f}}},
+        {{{1.000000f, -1.234695f, 1.000000f}}, {{-1.322280f, 0.902983f}}}
+    }});
+    measure("sos", N, 1, 1, [&](){
+        float y = 0;
+        for(float sample : samples)
+            y = sos.execute(sample);
+        sink = y;
+    });
+
+    Filter<3,2,float,float,float> filter({{0.120960f, -0.019523f, 0.120960f}}, {{-1.152464f, 0.462928f}});
+    measure("filter", N, 1, 1, [&](){
+        float y = 0;
+        for(float sample : samples)
+            y = filter.execute(sample);
+        sink = y;
+    });
+
+    if(N == BUFFER_SIZE)
+        fft_crossover = crossover<N>(samples);
+
+    Circular<N,float> circular;
+    circular.clear();
+    measure("circular", N, 1, 1, [&](){
+        float y = 0;
+        for(float sample : samples){
+            circular.push(sample);
+            y += circular[N / 2];
+        }
+        sink = y;
+    });
+}
+
+int main(int argc, char ** argv){
+    if(argc > 1) options.cpu = stoi(argv[1]);
+    if(argc > 2) options.repeats = max(1, stoi(argv[2]));
+    if(argc > 3) options.seconds = stod(argv[3]);
+    if(argc > 4) options.filter = argv[4];
+
+    //pinning keeps migrations and cross core cache misses out of the numbers
+    bool pinned = false;
+    if(options.cpu >= 0){
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(options.cpu, &set);
+        pinned = sched_setaffinity(0, sizeof(set), &set) == 0;
+        if(!pinned)
+            perror("bas-bench: sched_setaffinity");
+    }
+
+    counters = PerfCounters::available();
+    if(!counters)
+        fprintf(stderr, "bas-bench: no hardware counters, %s\n", PerfCounters::reason());
+
+    frameSize<256>();
+    frameSize<1024>();
+    frameSize<4096>();
+
+    printf("{\n");
+    printf("  \"benchmark\": \"bas-bench\",\n");
+    printf("  \"cpu\": %d,\n", pinned ? options.cpu : -1);
+    printf("  \"repeats\": %zu,\n", options.repeats);
+    printf("  \"seconds_per_repeat\": %g,\n", options.seconds);
+    printf("  \"sample_rate\": %zu,\n", SAMPLE_RATE);
+    printf("  \"counters\": %s,\n", counters ? "true" : "false");
+    printf("  \"fft_crossover\": {\"frame\": %zu, \"analyzers\": %zu},\n", BUFFER_SIZE, fft_crossover);
+    printf("  \"results\": [\n");
+    for(size_t i = 0; i < results.size(); i++){
+        const Result & result = results[i];
+        printf("    {\"kernel\": \"%s\", \"frame\": %zu, \"analyzers\": %zu, \"lanes\": %zu, \"iterations\": %zu, "
+            "\"ns_per_sample\": %.4f, \"ns_per_sample_best\": %.4f, \"samples_per_second\": %.1f",
+            result.kernel.data(), result.frame, result.analyzers, result.lanes, result.iterations,
+            result.median, result.best, 1e9 / result.median);
+        if(result.counted)
+            printf(", \"ipc\": %.3f, \"cycles_per_sample\": %.3f, \"instructions_per_sample\": %.3f, "
+                "\"cache_misses_per_sample\": %.5f, \"branch_misses_per_sample\": %.5f",
+                result.counters[PerfCounters::INSTRUCTIONS] / result.counters[PerfCounters::CYCLES],
+                result.counters[PerfCounters::CYCLES], result.counters[PerfCounters::INSTRUCTIONS],
+                result.counters[PerfCounters::CACHE_MISSES], result.counters[PerfCounters::BRANCH_MISSES]);
+        printf("}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    printf("  ]\n}\n");
+}
@@ -0,0 +1,75 @@
+#include "ResultRing.hpp"
+
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <vector>
+#include <stdexcept>
+
+using namespace std;
+
+static void printHeader(const ResultRingReader & reader){
+    printf("# time peak_frequency peak_magnitude");
+    for(size_t i = 0; i < reader.analyzers(); i++)
+        printf(" %.2f", reader.frequencies()[i]);
+    printf("\n");
+    fflush(stdout);
+}
+
+// Follows a bas-daemon result ring and prints every frame as text, across
+// daemon restarts
+int main(int argc, char ** argv){
+    if(argc != 2){
+        fprintf(stderr, "usage: %s <shm name>\n", argv[0]);
+        return 1;
+    }
+
+    try{
+        ResultRingReader reader(argv[1]);
+
+        printHeader(reader);
+
+        vector<float> magnitudes(reader.analyzers());
+        ResultRingReader::Frame frame;
+        size_t idle = 0;
+        while(true){
+            if(!reader.next(frame)){
+                this_thread::sleep_for(chrono::milliseconds(1));
+
+                //a quiet ring may belong to a writer that is gone, look every 100 ms
+                if(++idle % 100 == 0 && reader.replaced()){
+                    try{
+                        reader.reopen();
+                    }
+                    catch(const runtime_error &){
+                        continue;       //the new writer is not there yet
+                    }
+                    magnitudes.resize(reader.analyzers());
+                    printHeader(reader);
+                }
+                continue;
+            }
+            idle = 0;
+
+            uint64_t timestamp = frame.timestamp;
+            float peak_frequency = frame.peak_frequency;
+            float peak_magnitude = frame.peak_magnitude;
+            for(size_t i = 0; i < reader.analyzers(); i++)
+                magnitudes[i] = frame.magnitudes[i];
+
+            //the writer lapped us while reading
+            if(!reader.consistent(frame))
+                continue;
+
+            printf("%llu %.2f %.6f", (unsigned long long)timestamp, peak_frequency, peak_magnitude);
+            for(size_t i = 0; i < reader.analyzers(); i++)
+                printf(" %.6f", magnitudes[i]);
+            printf("\n");
+            fflush(stdout);
+        }
+    }
+    catch(const exception& e){
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+}
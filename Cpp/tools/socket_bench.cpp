@@ -0,0 +1,95 @@
+#include "SocketServer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <vector>
+#include <memory>
+#include <string>
+#include <stdexcept>
+
+using namespace std;
+using clock_t_ = chrono::steady_clock;
+
+// Publishes synthetic frames as fast as possible to local clients and
+// reports the publisher rate and what the clients actually received
+struct Result{
+    double published;
+    double received;
+    double megabytes;
+    double publish_ns;
+    uint64_t drops;
+};
+
+static Result run(const string & path, size_t analyzers, size_t batch, size_t clients, size_t queue, double seconds){
+    vector<float> frequencies(analyzers);
+    for(size_t i = 0; i < analyzers; i++)
+        frequencies[i] = 20.0f + i;
+
+    auto server = make_unique<SocketServer>(path, frequencies, batch, queue);
+
+    atomic<uint64_t> received = 0;
+    vector<thread> readers;
+    for(size_t i = 0; i < clients; i++)
+        readers.emplace_back([&](){
+            SocketClient client(path);
+            SocketBatch header;
+            while(client.receive(header))
+                received += header.frames;
+        });
+
+    //keep publishing until every reader got accepted
+    vector<float> magnitudes(analyzers, 0.5f);
+    while(server->connections() < clients){
+        for(size_t i = 0; i < batch; i++)
+            server->publish(0, {1000.0f, 1.0f}, magnitudes.data());
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    uint64_t warmup = server->drops();
+    received = 0;
+
+    uint64_t published = 0;
+    auto start = clock_t_::now();
+    auto end = start + chrono::duration<double>(seconds);
+    while(clock_t_::now() < end)
+        for(size_t i = 0; i < batch; i++)
+            server->publish(published++, {1000.0f, 1.0f}, magnitudes.data());
+    double elapsed = chrono::duration<double>(clock_t_::now() - start).count();
+    uint64_t got = received;
+    uint64_t drops = server->drops() - warmup;
+
+    //closing the server disconnects the readers
+    server.reset();
+    for(thread & reader : readers)
+        reader.join();
+
+    return {
+        published / elapsed,
+        got / elapsed / clients,
+        got * (sizeof(SocketFrame) + analyzers * sizeof(float)) / elapsed / 1e6,
+        elapsed * 1e9 / published,
+        drops
+    };
+}
+
+int main(int argc, char ** argv){
+    string path = argc > 1 ? argv[1] : "/tmp/bas-socket-bench.sock";
+    double seconds = argc > 2 ? stod(argv[2]) : 1.0;
+
+    printf("analyzers batch clients published/s received/s/client MB/s ns/publish dropped_batches\n");
+    try{
+        for(size_t analyzers : {16, 256, 2048})
+            for(size_t batch : {1, 8, 64})
+                for(size_t clients : {1, 4}){
+                    Result result = run(path, analyzers, batch, clients, 64, seconds);
+                    printf("%zu %zu %zu %.0f %.0f %.1f %.1f %llu\n", analyzers, batch, clients,
+                        result.published, result.received, result.megabytes, result.publish_ns, (unsigned long long)result.drops);
+                    fflush(stdout);
+                }
+    }
+    catch(const exception& e){
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+}
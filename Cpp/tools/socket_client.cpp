@@ -0,0 +1,48 @@
+#include "SocketServer.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+// Connects to a bas-daemon socket and prints every frame as text,
+// or only per batch statistics with --quiet
+int main(int argc, char ** argv){
+    bool quiet = argc == 3 && strcmp(argv[2], "--quiet") == 0;
+    if(argc != 2 && !quiet){
+        fprintf(stderr, "usage: %s <socket path> [--quiet]\n", argv[0]);
+        return 1;
+    }
+
+    try{
+        SocketClient client(argv[1]);
+
+        printf("# time peak_frequency peak_magnitude");
+        for(float frequency : client.frequencies())
+            printf(" %.2f", frequency);
+        printf("\n");
+
+        SocketBatch batch;
+        while(client.receive(batch)){
+            if(quiet){
+                printf("# batch %llu, %u frames, %llu skipped\n", (unsigned long long)batch.sequence, batch.frames, (unsigned long long)client.skipped());
+                fflush(stdout);
+                continue;
+            }
+
+            for(size_t i = 0; i < batch.frames; i++){
+                SocketFrame frame = client.frame(i);
+                printf("%llu %.2f %.6f", (unsigned long long)frame.timestamp, frame.peak_frequency, frame.peak_magnitude);
+                for(size_t j = 0; j < client.analyzers(); j++)
+                    printf(" %.6f", client.magnitudes(i)[j]);
+                printf("\n");
+            }
+            fflush(stdout);
+        }
+    }
+    catch(const exception& e){
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+}